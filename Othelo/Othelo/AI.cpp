@@ -1,74 +1,518 @@
 #include "AI.h"
-#include <SDL.h>
+#include <cmath>
+#include <cstring>
 
-AI::AI(AIDifficulty difficulty) : currentDifficulty(difficulty) {}
+// Transposition table bound types
+#define TT_EXACT    0
+#define TT_LOWER    1
+#define TT_UPPER    2
+
+AI::AI(AIDifficulty difficulty) : currentDifficulty(difficulty), settings(AI_LEVEL_SETTINGS[static_cast<int>(difficulty)]),
+	random(static_cast<unsigned>(std::chrono::system_clock::now().time_since_epoch().count())) {
+	tableMask = (size_t(1) << AI_TT_SIZE_BITS) - 1;
+	transpositionTable.reset(new TTEntry[tableMask + 1]);
+	SetThreadCount(static_cast<int>(std::thread::hardware_concurrency()));
+	endgameSolver.SetStopCallback([this]() { return CheckLimits(*workers[0]); });
+	mcts.SetStopCallback([this]() { return CheckLimits(*workers[0]); });
+}
 
 void AI::SetDifficulty(AIDifficulty difficulty) {
 	currentDifficulty = difficulty;
+	settings = AI_LEVEL_SETTINGS[static_cast<int>(difficulty)];
+}
+
+void AI::SetThreadCount(int count) {
+	count = std::max(1, std::min(count, AI_MAX_THREADS));
+
+	workers.clear();
+	for (int i = 0; i < count; i++) {
+		workers.emplace_back(new SearchWorker());
+		workers.back()->id = i;
+	}
+	ClearTables();
+}
+
+void AI::SetStateCheck(bool enable) {
+	checkState = enable;
+	for (auto& worker : workers) {
+		worker->stateChecks = 0;
+		worker->stateMismatches = 0;
+	}
+}
+
+void AI::GetStateCheckCounts(uint64_t& checks, uint64_t& mismatches) const {
+	checks = 0;
+	mismatches = 0;
+	for (auto& worker : workers) {
+		checks += worker->stateChecks;
+		mismatches += worker->stateMismatches;
+	}
+}
+
+void AI::ClearTables() {
+	for (size_t i = 0; i <= tableMask; i++) {
+		transpositionTable[i].check.store(0, std::memory_order_relaxed);
+		transpositionTable[i].data.store(0, std::memory_order_relaxed);
+	}
+
+	for (auto& worker : workers) {
+		std::fill(&worker->killerMoves[0][0], &worker->killerMoves[0][0] + AI_MAX_PLY * 2, -1);
+		std::fill(worker->history, worker->history + BOARD_CELLS, 0);
+	}
+	endgameSolver.ClearTable();
 }
 
-std::pair<int, int> AI::MakeMove(const std::vector<std::vector<char>>& board, char player) {
-	// Now only calls MakeRandomMove since other difficulties are removed
-	SDL_Delay(1000);
-	return MakeRandomMove(board, player);
+std::pair<int, int> AI::MakeMove(const Board& board, char player) {
+	stopRequested = false;
+	return Search(board, player);
 }
 
-std::pair<int, int> AI::MakeRandomMove(const std::vector<std::vector<char>>& board, char player) {
-	auto validMoves = GetValidMoves(board, player);
-	if (validMoves.empty()) return { -1, -1 }; // No valid moves
+std::future<std::pair<int, int>> AI::StartSearch(const Board& board, char player) {
+	// Clear the flag here, so a Stop() issued right after this call is never lost
+	stopRequested = false;
+	return std::async(std::launch::async, [this, board, player]() {
+		return Search(board, player);
+	});
+}
+
+std::pair<int, int> AI::Search(const Board& board, char player) {
+	Bitboard own = board.Pieces(player);
+	Bitboard other = board.Pieces(OpponentOf(player));
+	if (!GetMovesMask(own, other)) return { -1, -1 }; // No valid moves
+
+	if (settings.useBook) {
+		int bookMove = PickBookMove(own, other);
+		if (bookMove >= 0) {
+			totalNodes = 0;
+			completedDepth = 0;
+			return { bookMove / BOARD_SIZE, bookMove % BOARD_SIZE };
+		}
+	}
+
+	if (settings.useMcts) return SearchMcts(own, other);
+
+	// Iterative deepening: each completed iteration seeds the move ordering of the next one
+	stopSearch = false;
+	completedDepth = 0;
+	searchStart = std::chrono::steady_clock::now();
+
+	for (auto& worker : workers) {
+		worker->nodes = 0;
+		worker->publishedNodes = 0;
+
+		// Age the history so old games do not dominate the ordering
+		for (int& value : worker->history) value /= 4;
+	}
+
+	// Every worker tracks the evaluator state incrementally from the root position
+	for (auto& worker : workers) {
+		if (network.IsLoaded()) network.ComputeState(board.Pieces(BLACK_PIECE), board.Pieces(WHITE_PIECE), worker->network);
+		else evaluator.ComputeState(board.Pieces(BLACK_PIECE), board.Pieces(WHITE_PIECE), worker->patterns);
+		worker->blackToMove = (player == BLACK_PIECE);
+	}
+
+	int empties = PopCount(~(own | other));
+	int maxDepth = std::min(settings.maxDepth, empties);
+	int bestMove = -1;
+
+	// Near the end the solver takes over, the midgame search only provides a fallback move
+	bool solveExact = empties <= settings.endgameEmpties;
+	bool solveWinLoss = !solveExact && empties <= settings.winLossEmpties;
+	if (solveExact || solveWinLoss) maxDepth = std::min(maxDepth, AI_ENDGAME_FALLBACK_DEPTH);
+
+	// Lazy SMP: helpers run their own iterative deepening and only talk through the shared table
+	std::vector<std::thread> helpers;
+	for (size_t i = 1; i < workers.size(); i++) {
+		helpers.emplace_back(&AI::HelperSearch, this, std::ref(*workers[i]), own, other, maxDepth);
+	}
+
+	SearchWorker& mainWorker = *workers[0];
+	for (int depth = 1; depth <= maxDepth; depth++) {
+		int iterationMove = bestMove;
+		int score = SearchRoot(mainWorker, own, other, depth, iterationMove);
+		if (stopSearch) break;
+
+		bestMove = iterationMove;
+		lastScore = score;
+		completedDepth = depth;
+		if (infoCallback) {
+			uint64_t nodes = mainWorker.nodes;
+			for (size_t i = 1; i < workers.size(); i++) nodes += workers[i]->publishedNodes.load(std::memory_order_relaxed);
+			ReportProgress(own, other, bestMove, nodes);
+		}
+
+		// A proven result cannot change at higher depths
+		if (score > SCORE_EVAL_LIMIT || score < -SCORE_EVAL_LIMIT) break;
+	}
+
+	stopSearch = true;
+	for (auto& helper : helpers) helper.join();
+
+	totalNodes = 0;
+	for (auto& worker : workers) totalNodes += worker->nodes;
+
+	if ((solveExact || solveWinLoss) && !CheckLimits(mainWorker)) {
+		SolveEndgame(own, other, solveWinLoss, bestMove);
+	}
+
+	if (bestMove < 0) return MakeRandomMove(board, player);
+	return { bestMove / BOARD_SIZE, bestMove % BOARD_SIZE };
+}
+
+std::pair<int, int> AI::MakeRandomMove(const Board& board, char player) {
+	Bitboard moves = board.GetValidMoves(player);
+	if (!moves) return { -1, -1 }; // No valid moves
+
+	std::vector<int> validMoves;
+	while (moves) {
+		validMoves.push_back(PopLowestBit(moves));
+	}
+
+	std::shuffle(validMoves.begin(), validMoves.end(), random);
+	return { validMoves[0] / BOARD_SIZE, validMoves[0] % BOARD_SIZE };
+}
+
+int AI::PickBookMove(Bitboard player, Bitboard opponent) {
+	BookMove moves[BOOK_MAX_MOVES];
+	int count = book.GetMoves(player, opponent, moves, BOOK_MAX_MOVES);
+
+	// Weighted choice, so the AI does not repeat the same opening every game
+	int totalWeight = 0;
+	for (int i = 0; i < count; i++) totalWeight += moves[i].weight;
+	if (totalWeight <= 0) return -1;
+
+	int pick = static_cast<int>(random() % static_cast<unsigned>(totalWeight));
+	for (int i = 0; i < count; i++) {
+		pick -= moves[i].weight;
+		if (pick < 0) {
+			lastScore = moves[i].score;
+			return moves[i].square;
+		}
+	}
+	return -1;
+}
+
+void AI::SolveEndgame(Bitboard player, Bitboard opponent, bool winLossOnly, int& bestMove) {
+	int move = -1;
+	int score = 0;
+	bool solved = endgameSolver.SolveRoot(player, opponent, winLossOnly, move, score);
+	totalNodes += endgameSolver.GetNodeCount();
+	if (!solved) return; // Out of time: keep the midgame move
+
+	// A lost win/loss search does not tell which move loses by less, the midgame move is a better try
+	if (winLossOnly && score < 0 && bestMove >= 0) return;
+
+	bestMove = move;
+	completedDepth = PopCount(~(player | opponent));
+	lastScore = (score > 0) ? SCORE_WIN + score : (score < 0) ? -SCORE_WIN + score : 0;
+	if (infoCallback) ReportProgress(player, opponent, bestMove, totalNodes);
+}
+
+void AI::HelperSearch(SearchWorker& worker, Bitboard player, Bitboard opponent, int maxDepth) {
+	// Odd helpers start one ply deeper, so the threads spread over different depths
+	for (int depth = 1 + (worker.id & 1); depth <= maxDepth; depth++) {
+		int move = -1;
+		SearchRoot(worker, player, opponent, depth, move);
+		if (stopSearch) break;
+	}
+}
+
+std::pair<int, int> AI::SearchMcts(Bitboard player, Bitboard opponent) {
+	// The playout limit is handled by the tree search, the shared stop check only sees time and Stop()
+	searchStart = std::chrono::steady_clock::now();
+	for (auto& worker : workers) {
+		worker->nodes = 0;
+		worker->publishedNodes = 0;
+	}
+
+	int move = mcts.Search(player, opponent, GetThreadCount(), settings.nodeLimit, random());
+	totalNodes = mcts.GetPlayoutCount();
+	lastScore = static_cast<int>(std::lround((2.0 * mcts.GetWinRate() - 1.0) * MCTS_SCORE_SCALE));
+
+	SearchInfo info;
+	mcts.GetPrincipalVariation(info.principalVariation);
+	completedDepth = static_cast<int>(info.principalVariation.size());
+	if (infoCallback) {
+		info.depth = completedDepth;
+		info.score = lastScore;
+		info.nodes = totalNodes;
+		info.elapsedMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			std::chrono::steady_clock::now() - searchStart).count());
+		infoCallback(info);
+	}
 
-	unsigned seed = std::chrono::system_clock::now().time_since_epoch().count();
-	std::shuffle(validMoves.begin(), validMoves.end(), std::default_random_engine(seed));
-	return validMoves[0];
+	if (move < 0) return { -1, -1 };
+	return { move / BOARD_SIZE, move % BOARD_SIZE };
 }
 
-// Helper functions (kept as they are needed by MakeRandomMove)
-std::vector<std::pair<int, int>> AI::GetValidMoves(const std::vector<std::vector<char>>& board, char player) {
-	std::vector<std::pair<int, int>> validMoves;
-	for (int row = 0; row < 8; ++row) {
-		for (int col = 0; col < 8; ++col) {
-			if (IsValidMove(board, row, col, player)) {
-				validMoves.emplace_back(row, col);
+int AI::SearchRoot(SearchWorker& worker, Bitboard player, Bitboard opponent, int depth, int& bestMove) {
+	int moveList[BOARD_CELLS];
+	int moveCount = OrderMoves(worker, GetMovesMask(player, opponent), bestMove, 0, moveList);
+
+	int alpha = -SCORE_INFINITY;
+	int beta = SCORE_INFINITY;
+
+	for (int i = 0; i < moveCount; i++) {
+		int move = moveList[i];
+		Bitboard flips = GetFlipsMask(move, player, opponent);
+		PlayMove(worker, player, opponent, move, flips);
+
+		// Principal variation search: full window for the first move, null window for the rest
+		int score;
+		if (i == 0) {
+			score = -Negamax(worker, opponent, player, depth - 1, -beta, -alpha, 1, false);
+		}
+		else {
+			score = -Negamax(worker, opponent, player, depth - 1, -alpha - 1, -alpha, 1, false);
+			if (score > alpha && !stopSearch) {
+				score = -Negamax(worker, opponent, player, depth - 1, -beta, -alpha, 1, false);
 			}
 		}
+
+		TakeBackMove(worker, player, opponent, move, flips);
+
+		if (stopSearch) break;
+
+		if (score > alpha) {
+			alpha = score;
+			bestMove = move;
+		}
 	}
-	return validMoves;
+
+	return alpha;
 }
 
-bool AI::IsValidMove(const std::vector<std::vector<char>>& board, int row, int col, char player) {
-	if (board[row][col] != ' ') return false;
+int AI::Negamax(SearchWorker& worker, Bitboard player, Bitboard opponent, int depth, int alpha, int beta, int ply, bool passed) {
+	if ((++worker.nodes & 4095) == 0) {
+		worker.publishedNodes.store(worker.nodes, std::memory_order_relaxed);
+		if (worker.id == 0 && CheckLimits(worker)) stopSearch = true;
+	}
+	if (stopSearch.load(std::memory_order_relaxed)) return 0;
+
+	Bitboard moves = GetMovesMask(player, opponent);
+	if (!moves) {
+		if (passed || !GetMovesMask(opponent, player)) {
+			// Game over: score the final disc difference
+			int diff = PopCount(player) - PopCount(opponent);
+			if (diff > 0) return SCORE_WIN + diff;
+			if (diff < 0) return -SCORE_WIN + diff;
+			return 0;
+		}
+		// Pass: only the side to move changes
+		worker.blackToMove = !worker.blackToMove;
+		int score = -Negamax(worker, opponent, player, depth, -beta, -alpha, ply + 1, true);
+		worker.blackToMove = !worker.blackToMove;
+		return score;
+	}
 
-	char opponent = (player == 'B') ? 'W' : 'B';
-	bool isValid = false;
+	if (depth <= 0 || ply >= AI_MAX_PLY) {
+		return Evaluate(worker, player, opponent);
+	}
+
+	// Transposition table lookup
+	uint64_t key = HashPosition(player, opponent);
+	TTData entry;
+	int ttMove = -1;
+	if (ProbeTable(key, entry)) {
+		ttMove = entry.bestMove;
+		if (entry.depth >= depth) {
+			if (entry.flag == TT_EXACT) return entry.score;
+			if (entry.flag == TT_LOWER && entry.score >= beta) return entry.score;
+			if (entry.flag == TT_UPPER && entry.score <= alpha) return entry.score;
+		}
+	}
 
-	// Check all 8 directions
-	for (int dr = -1; dr <= 1; dr++) {
-		for (int dc = -1; dc <= 1; dc++) {
-			if (dr == 0 && dc == 0) continue;
+	int moveList[BOARD_CELLS];
+	int moveCount = OrderMoves(worker, moves, ttMove, ply, moveList);
 
-			int r = row + dr;
-			int c = col + dc;
-			bool foundOpponent = false;
+	int originalAlpha = alpha;
+	int bestScore = -SCORE_INFINITY;
+	int bestMove = -1;
 
-			while (r >= 0 && r < 8 && c >= 0 && c < 8) {
-				if (board[r][c] == opponent) {
-					foundOpponent = true;
-				}
-				else if (board[r][c] == player && foundOpponent) {
-					isValid = true;
-					break;
-				}
-				else {
-					break;
-				}
+	for (int i = 0; i < moveCount; i++) {
+		int move = moveList[i];
+		Bitboard flips = GetFlipsMask(move, player, opponent);
+		PlayMove(worker, player, opponent, move, flips);
 
-				r += dr;
-				c += dc;
+		int score;
+		if (i == 0) {
+			score = -Negamax(worker, opponent, player, depth - 1, -beta, -alpha, ply + 1, false);
+		}
+		else {
+			score = -Negamax(worker, opponent, player, depth - 1, -alpha - 1, -alpha, ply + 1, false);
+			if (score > alpha && score < beta && !stopSearch) {
+				score = -Negamax(worker, opponent, player, depth - 1, -beta, -alpha, ply + 1, false);
+			}
+		}
+
+		TakeBackMove(worker, player, opponent, move, flips);
+
+		if (stopSearch) return 0;
+
+		if (score > bestScore) {
+			bestScore = score;
+			bestMove = move;
+		}
+		if (score > alpha) {
+			alpha = score;
+		}
+		if (alpha >= beta) {
+			// Quiet cutoff move: remember it for the siblings and for the whole search
+			if (worker.killerMoves[ply][0] != move) {
+				worker.killerMoves[ply][1] = worker.killerMoves[ply][0];
+				worker.killerMoves[ply][0] = move;
 			}
+			worker.history[move] += depth * depth;
+			break;
+		}
+	}
+
+	StoreTable(key, depth, bestScore, originalAlpha, beta, bestMove);
+	return bestScore;
+}
+
+int AI::OrderMoves(const SearchWorker& worker, Bitboard moves, int ttMove, int ply, int* moveList) const {
+	int scores[BOARD_CELLS];
+	int count = 0;
+
+	while (moves) {
+		int move = PopLowestBit(moves);
+		int score;
+		if (move == ttMove) score = 1 << 30;
+		else if (move == worker.killerMoves[ply][0]) score = 1 << 29;
+		else if (move == worker.killerMoves[ply][1]) score = 1 << 28;
+		else score = worker.history[move] + SQUARE_WEIGHTS[move];
+
+		// Insertion sort, the lists are short
+		int i = count++;
+		while (i > 0 && scores[i - 1] < score) {
+			scores[i] = scores[i - 1];
+			moveList[i] = moveList[i - 1];
+			i--;
+		}
+		scores[i] = score;
+		moveList[i] = move;
+	}
+
+	return count;
+}
+
+int AI::Evaluate(const SearchWorker& worker, Bitboard player, Bitboard opponent) const {
+	int score = network.IsLoaded() ? network.Evaluate(worker.network, worker.blackToMove)
+		: evaluator.Evaluate(worker.patterns, player, opponent, worker.blackToMove);
+	return std::max(-SCORE_EVAL_LIMIT, std::min(SCORE_EVAL_LIMIT, score));
+}
+
+// Makes a move of the side to move in place: the discs (ToggleMove) and the evaluator state of the worker
+void AI::PlayMove(SearchWorker& worker, Bitboard& player, Bitboard& opponent, int move, Bitboard flips) const {
+	ToggleMove(player, opponent, 1ULL << move, flips);
+	int color = worker.blackToMove ? 1 : 2;
+	if (network.IsLoaded()) network.MakeMove(worker.network, move, flips, color);
+	else evaluator.MakeMove(worker.patterns, move, flips, color);
+	worker.blackToMove = !worker.blackToMove;
+	if (checkState) CheckState(worker, worker.blackToMove ? opponent : player, worker.blackToMove ? player : opponent);
+}
+
+void AI::TakeBackMove(SearchWorker& worker, Bitboard& player, Bitboard& opponent, int move, Bitboard flips) const {
+	ToggleMove(player, opponent, 1ULL << move, flips);
+	worker.blackToMove = !worker.blackToMove;
+	if (network.IsLoaded()) network.UndoMove(worker.network);
+	else evaluator.UndoMove(worker.patterns, move, flips, worker.blackToMove ? 1 : 2);
+	if (checkState) CheckState(worker, worker.blackToMove ? player : opponent, worker.blackToMove ? opponent : player);
+}
 
-			if (isValid) break;
+void AI::CheckState(SearchWorker& worker, Bitboard black, Bitboard white) const {
+	bool match;
+	if (network.IsLoaded()) {
+		if (!worker.checkNetwork) worker.checkNetwork.reset(new NnueState());
+		network.ComputeState(black, white, *worker.checkNetwork);
+		match = memcmp(worker.network.accumulators[worker.network.top], worker.checkNetwork->accumulators[0],
+			sizeof(worker.checkNetwork->accumulators[0])) == 0;
+	}
+	else {
+		PatternState patterns;
+		evaluator.ComputeState(black, white, patterns);
+		match = memcmp(worker.patterns.indices, patterns.indices, sizeof(patterns.indices)) == 0;
+	}
+	worker.stateChecks++;
+	if (!match) worker.stateMismatches++;
+}
+
+bool AI::CheckLimits(const SearchWorker& worker) {
+	if (stopRequested) return true;
+
+	if (settings.nodeLimit) {
+		uint64_t nodes = worker.nodes;
+		for (auto& helper : workers) {
+			if (helper.get() != &worker) nodes += helper->publishedNodes.load(std::memory_order_relaxed);
 		}
+		if (nodes >= settings.nodeLimit) return true;
 	}
 
-	return isValid;
-}
\ No newline at end of file
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStart);
+	return settings.timeLimitMs && elapsed.count() >= settings.timeLimitMs;
+}
+
+void AI::ReportProgress(Bitboard player, Bitboard opponent, int bestMove, uint64_t nodes) {
+	SearchInfo info;
+	info.depth = completedDepth;
+	info.score = lastScore;
+	info.nodes = nodes;
+	info.elapsedMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now() - searchStart).count());
+
+	// The root move, then the best moves stored in the table, as long as they are still legal
+	int move = bestMove;
+	for (int ply = 0; ply < completedDepth && move >= 0; ply++) {
+		info.principalVariation.push_back(move);
+		ToggleMove(player, opponent, 1ULL << move, GetFlipsMask(move, player, opponent));
+		std::swap(player, opponent);
+
+		if (!GetMovesMask(player, opponent)) {
+			if (!GetMovesMask(opponent, player)) break;
+			info.principalVariation.push_back(-1);
+			std::swap(player, opponent);
+		}
+
+		TTData entry;
+		move = -1;
+		if (ProbeTable(HashPosition(player, opponent), entry) && entry.bestMove >= 0 &&
+			((GetMovesMask(player, opponent) >> entry.bestMove) & 1)) {
+			move = entry.bestMove;
+		}
+	}
+
+	infoCallback(info);
+}
+
+bool AI::ProbeTable(uint64_t key, TTData& entry) const {
+	const TTEntry& slot = transpositionTable[key & tableMask];
+	uint64_t data = slot.data.load(std::memory_order_relaxed);
+	uint64_t check = slot.check.load(std::memory_order_relaxed);
+
+	// Another thread may have overwritten half of the slot: the XOR only matches for a consistent pair
+	if ((check ^ data) != key) return false;
+
+	entry.score = static_cast<int16_t>(data & 0xFFFF);
+	entry.depth = static_cast<int>((data >> 16) & 0xFF);
+	entry.flag = static_cast<int>((data >> 24) & 0xFF);
+	entry.bestMove = static_cast<int8_t>((data >> 32) & 0xFF);
+	return true;
+}
+
+void AI::StoreTable(uint64_t key, int depth, int score, int alpha, int beta, int bestMove) {
+	TTEntry& slot = transpositionTable[key & tableMask];
+
+	// Keep deeper results for the same position
+	TTData existing;
+	if (ProbeTable(key, existing) && existing.depth > depth) return;
+
+	int flag = (score <= alpha) ? TT_UPPER : (score >= beta) ? TT_LOWER : TT_EXACT;
+	uint64_t data = static_cast<uint16_t>(score)
+		| static_cast<uint64_t>(depth & 0xFF) << 16
+		| static_cast<uint64_t>(flag) << 24
+		| static_cast<uint64_t>(static_cast<uint8_t>(bestMove)) << 32;
+
+	slot.check.store(key ^ data, std::memory_order_relaxed);
+	slot.data.store(data, std::memory_order_relaxed);
+}
@@ -4,26 +4,187 @@
 #include <algorithm>
 #include <random>
 #include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include "Board.h"
+#include "Endgame.h"
+#include "Book.h"
+#include "Pattern.h"
+#include "Nnue.h"
+#include "Mcts.h"
+
+#define AI_MAX_PLY              64
+#define AI_TT_SIZE_BITS         20          // 2^20 entries (16 MB)
+#define AI_MAX_THREADS          64
+#define AI_ENDGAME_FALLBACK_DEPTH   6       // Midgame search run before the solver, in case it runs out of time
+#define AI_BOOK_FILE            "book.bin"
+#define AI_WEIGHTS_FILE         "weights.bin"
+#define AI_NETWORK_FILE         "network.bin"
+
+// Search scores: final positions are WIN_SCORE + disc difference, heuristics stay below EVAL_LIMIT
+#define SCORE_INFINITY          32000
+#define SCORE_WIN               10000
+#define SCORE_EVAL_LIMIT        9000
 
-// Keep only EASY difficulty
 enum class AIDifficulty {
-	EASY
+	EASY,
+	MEDIUM,
+	HARD,
+	EXPERT,
+	DIFFICULTY_COUNT
+};
+
+// Search budget for each difficulty level (0 = no limit)
+struct AILevelSettings {
+	int maxDepth;
+	int timeLimitMs;
+	uint64_t nodeLimit;
+	int endgameEmpties;         // Solve the exact final score from this many empty squares down
+	int winLossEmpties;         // Solve only win/draw/loss from this many empty squares down
+	bool useBook;               // Play opening book moves while the position is in the book
+	bool useMcts;               // Monte Carlo Tree Search instead of alpha-beta, nodeLimit then counts playouts
+};
+
+// EASY plays by tree search: a few hundred playouts give plausible but beatable moves, which replaced
+// the depth-2 search with 25% random moves it used before
+static const AILevelSettings AI_LEVEL_SETTINGS[] = {
+	{ 2,  100,   300,    0,  0,  false, true },     // EASY
+	{ 4,  250,   200000, 10, 12, true,  false },    // MEDIUM
+	{ 10, 1500,  0,      16, 18, true,  false },    // HARD
+	{ 60, 4000,  0,      20, 22, true,  false }     // EXPERT
+};
+
+// Progress of a running search, reported after every completed iteration
+struct SearchInfo {
+	int depth;
+	int score;                              // Side to move, proven results are SCORE_WIN + disc difference
+	uint64_t nodes;
+	int elapsedMs;
+	std::vector<int> principalVariation;    // Squares, -1 for a pass
+};
+
+// Transposition table entry, shared lock-free by all search threads.
+// The key is stored XORed with the data, so a torn write fails validation instead of returning garbage.
+struct TTEntry {
+	std::atomic<uint64_t> check{ 0 };   // key ^ data
+	std::atomic<uint64_t> data{ 0 };    // score | depth << 16 | flag << 24 | bestMove << 32
+};
+
+// Unpacked transposition table data
+struct TTData {
+	int score;
+	int depth;
+	int flag;
+	int bestMove;
+};
+
+// Per-thread search state (Lazy SMP: every thread owns its ordering tables)
+struct SearchWorker {
+	int id = 0;
+	int killerMoves[AI_MAX_PLY][2];
+	int history[BOARD_CELLS];
+	uint64_t nodes = 0;
+	PatternState patterns;                      // Pattern indices of the position being searched
+	NnueState network;                          // Network accumulators along the search path
+	bool blackToMove = true;
+	std::atomic<uint64_t> publishedNodes{ 0 };  // Copy of nodes readable by the main thread
+
+	// State check (AI::SetStateCheck): recomputed state and counts
+	std::unique_ptr<NnueState> checkNetwork;
+	uint64_t stateChecks = 0;
+	uint64_t stateMismatches = 0;
 };
 
 class AI {
 public:
-	// Constructor now only needs difficulty
 	AI(AIDifficulty difficulty = AIDifficulty::EASY);
-	void SetDifficulty(AIDifficulty difficulty); // Can still be used to set EASY
-	std::pair<int, int> MakeMove(const std::vector<std::vector<char>>& board, char player);
+	void SetDifficulty(AIDifficulty difficulty);
+	AIDifficulty GetDifficulty() const { return currentDifficulty; }
+	std::pair<int, int> MakeMove(const Board& board, char player);
+
+	// Background search: the result arrives through the future, Stop() makes it return early
+	std::future<std::pair<int, int>> StartSearch(const Board& board, char player);
+	void Stop() { stopRequested = true; }
+
+	// Parallel search: 1 = single thread, N = main thread plus N-1 helpers sharing the table
+	void SetThreadCount(int count);
+	int GetThreadCount() const { return static_cast<int>(workers.size()); }
+
+	// Opening book (memory-mapped, shared by all AI instances of the process through the OS page cache)
+	bool LoadBook(const char* path) { return book.Open(path); }
+	bool HasBook() const { return book.IsOpen(); }
+
+	// Evaluation weights (the built-in ones are used until a file is loaded)
+	bool LoadWeights(const char* path) { return evaluator.LoadWeights(path); }
+
+	// Neural network evaluation, used instead of the patterns once a network is loaded
+	bool LoadNetwork(const char* path) { return network.LoadWeights(path); }
+	bool HasNetwork() const { return network.IsLoaded(); }
+
+	// Debug check of the incremental evaluator state: after every move made and taken back in the search,
+	// each worker's pattern indices or network accumulators are compared with a full recomputation.
+	// Slow, for the CLI checks. Enabling it resets the counts.
+	void SetStateCheck(bool enable);
+	void GetStateCheckCounts(uint64_t& checks, uint64_t& mismatches) const;
+
+	// Overrides the level budget (used by the benchmarks)
+	void SetLimits(const AILevelSettings& limits) { settings = limits; }
+	void ClearTables();
+
+	// Makes the random choices (book moves, tree search playouts) repeatable, for engine matches
+	void SetSeed(uint64_t seed) { random.seed(static_cast<std::mt19937::result_type>(seed ^ (seed >> 32))); }
+
+	// Called on the searching thread, after each iteration and after an endgame solve
+	void SetInfoCallback(std::function<void(const SearchInfo&)> callback) { infoCallback = callback; }
+
+	// Statistics of the last search
+	uint64_t GetNodeCount() const { return totalNodes; }
+	int GetLastDepth() const { return completedDepth; }
+	int GetLastScore() const { return lastScore; }
 
 private:
 	AIDifficulty currentDifficulty;
+	AILevelSettings settings;
+
+	// Search state (lives across moves so the tables stay warm)
+	std::unique_ptr<TTEntry[]> transpositionTable;
+	size_t tableMask = 0;
+	std::vector<std::unique_ptr<SearchWorker>> workers;
+	std::atomic<bool> stopSearch{ false };
+	std::atomic<bool> stopRequested{ false };
+	uint64_t totalNodes = 0;
+	int completedDepth = 0;
+	int lastScore = 0;
+	bool checkState = false;
+	std::chrono::steady_clock::time_point searchStart;
+	EndgameSolver endgameSolver;
+	MctsSearcher mcts;
+	OpeningBook book;
+	PatternEvaluator evaluator;
+	NnueEvaluator network;
+	std::mt19937 random;
+	std::function<void(const SearchInfo&)> infoCallback;
 
-	// Only keep MakeRandomMove
-	std::pair<int, int> MakeRandomMove(const std::vector<std::vector<char>>& board, char player);
+	std::pair<int, int> Search(const Board& board, char player);
+	std::pair<int, int> SearchMcts(Bitboard player, Bitboard opponent);
+	std::pair<int, int> MakeRandomMove(const Board& board, char player);
+	int PickBookMove(Bitboard player, Bitboard opponent);
+	void HelperSearch(SearchWorker& worker, Bitboard player, Bitboard opponent, int maxDepth);
+	int SearchRoot(SearchWorker& worker, Bitboard player, Bitboard opponent, int depth, int& bestMove);
+	int Negamax(SearchWorker& worker, Bitboard player, Bitboard opponent, int depth, int alpha, int beta, int ply, bool passed);
+	void SolveEndgame(Bitboard player, Bitboard opponent, bool winLossOnly, int& bestMove);
+	int OrderMoves(const SearchWorker& worker, Bitboard moves, int ttMove, int ply, int* moveList) const;
+	int Evaluate(const SearchWorker& worker, Bitboard player, Bitboard opponent) const;
+	void PlayMove(SearchWorker& worker, Bitboard& player, Bitboard& opponent, int move, Bitboard flips) const;
+	void TakeBackMove(SearchWorker& worker, Bitboard& player, Bitboard& opponent, int move, Bitboard flips) const;
+	void CheckState(SearchWorker& worker, Bitboard black, Bitboard white) const;
+	bool CheckLimits(const SearchWorker& worker);
+	void ReportProgress(Bitboard player, Bitboard opponent, int bestMove, uint64_t nodes);
 
-	// Keep helper functions used by MakeRandomMove
-	std::vector<std::pair<int, int>> GetValidMoves(const std::vector<std::vector<char>>& board, char player);
-	bool IsValidMove(const std::vector<std::vector<char>>& board, int row, int col, char player);
-};
\ No newline at end of file
+	bool ProbeTable(uint64_t key, TTData& data) const;
+	void StoreTable(uint64_t key, int depth, int score, int alpha, int beta, int bestMove);
+};
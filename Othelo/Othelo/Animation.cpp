@@ -0,0 +1,49 @@
+#include "Animation.h"
+#include <algorithm>
+#include <cstdlib>
+
+void AnimationTimeline::Clear() {
+	for (int row = 0; row < VARIANT_MAX_SIZE; row++) {
+		for (int col = 0; col < VARIANT_MAX_SIZE; col++) {
+			slots[row][col].active = false;
+		}
+	}
+	activeCells = CellSet();
+}
+
+void AnimationTimeline::AddFlips(int square, CellSet flips, char from, char to, Uint32 currentTime) {
+	int originRow = square / GRID_SIZE;
+	int originCol = square % GRID_SIZE;
+
+	while (flips) {
+		int flipped = PopLowestBit(flips);
+		int row = flipped / GRID_SIZE;
+		int col = flipped % GRID_SIZE;
+		int distance = std::max(std::abs(row - originRow), std::abs(col - originCol));
+
+		// A newer move replaces whatever the cell was still showing
+		PieceAnimation& slot = slots[row][col];
+		slot.startPiece = from;
+		slot.endPiece = to;
+		slot.startTime = currentTime + (distance - 1) * ANIMATION_STAGGER_MS;
+		slot.active = true;
+		activeCells |= CellSet(1) << flipped;
+	}
+}
+
+int AnimationTimeline::Update(Uint32 currentTime) {
+	int finished = 0;
+	CellSet cells = activeCells;
+	while (cells) {
+		int square = PopLowestBit(cells);
+		PieceAnimation& slot = slots[square / GRID_SIZE][square % GRID_SIZE];
+
+		// Staggered flips have a start time in the future
+		if (static_cast<Sint32>(currentTime - slot.startTime) >= ANIMATION_DURATION_MS) {
+			slot.active = false;
+			activeCells &= ~(CellSet(1) << square);
+			finished++;
+		}
+	}
+	return finished;
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <SDL.h>
+#include "Main.h"
+
+// Estrutura para animação de peça
+struct PieceAnimation {
+	char startPiece;
+	char endPiece;
+	Uint32 startTime;
+	bool active;
+};
+
+// Flip animations, one slot per cell. The board is committed before the animation starts,
+// the timeline only replays the flips on screen.
+class AnimationTimeline {
+public:
+	AnimationTimeline() { Clear(); }
+	void Clear();
+
+	// Queues the flips of a move: discs further from the placed one start later, so captures cascade
+	void AddFlips(int square, CellSet flips, char from, char to, Uint32 currentTime);
+
+	// Animation of a cell, or null when it shows the board disc
+	const PieceAnimation* Get(int row, int col) const {
+		const PieceAnimation& slot = slots[row][col];
+		return slot.active ? &slot : nullptr;
+	}
+
+	// Retires finished animations, returns how many finished
+	int Update(Uint32 currentTime);
+	bool IsEmpty() const { return !activeCells; }
+
+private:
+	PieceAnimation slots[VARIANT_MAX_SIZE][VARIANT_MAX_SIZE];
+	CellSet activeCells;
+};
@@ -0,0 +1,377 @@
+#include "Bench.h"
+#include "AI.h"
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+// Middle-game positions for the search benchmarks (move lists from the start position)
+static const char* BENCH_POSITIONS[] = {
+	"f5d6c3d3c4f4f6f3e6e7",
+	"f5f6e6f4e3c5c4d3",
+	"f5d6c5f4e3f6g5e6e7",
+	"f5f6e6f4g5e7f7",
+	"f5d6c3d3c4f4c5b3c2e6"
+};
+
+// Target solve time for one 20-empty position; slower solves are reported with their shortfall
+#define ENDGAME_TARGET_MS 1000.0
+
+// Endgame positions from the FFO test suite, with their published best move and exact score
+static const char* ENDGAME_POSITIONS[] = {
+	"--XXXXX--OOOXX-O-OOOXXOX-OXOXOXXOXXXOXXX--XOXOXX-XXXOOO--OOOOO-- X; G8:+18",      // #1, 14 empties
+	"O--OOOOX-OOOOOOXOOXXOOOXOOXOOOXXOOOOOOXX---OOOOX----O--X-------- X; A2:+38"       // #40, 20 empties
+};
+
+// Reads "<64 cells> <side>", returns false on malformed input
+static bool ParsePosition(const std::string& line, Bitboard& player, Bitboard& opponent) {
+	Bitboard black = 0;
+	Bitboard white = 0;
+	size_t cell = 0;
+	size_t i = 0;
+	for (; i < line.size() && cell < BOARD_CELLS; i++) {
+		char c = line[i];
+		if (c == 'X' || c == 'x' || c == '*') black |= 1ULL << cell++;
+		else if (c == 'O' || c == 'o') white |= 1ULL << cell++;
+		else if (c == '-' || c == '.') cell++;
+		else if (c != ' ' && c != '\t') return false;
+	}
+	if (cell < BOARD_CELLS) return false;
+
+	while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) i++;
+	if (i >= line.size()) return false;
+
+	char side = line[i];
+	if (side == 'X' || side == 'x' || side == '*') { player = black; opponent = white; }
+	else if (side == 'O' || side == 'o') { player = white; opponent = black; }
+	else return false;
+	return true;
+}
+
+// Reads the "; <move>:<score>" annotations after the side to move. The best score is the expected one
+// and every move listed with it is a best move. Returns false when the line has no annotation.
+static bool ParseExpectedResult(const std::string& line, Bitboard& bestMoves, int& score) {
+	bestMoves = 0;
+	score = -BOARD_CELLS - 1;
+	for (size_t i = line.find(';'); i != std::string::npos; i = line.find(';', i + 1)) {
+		size_t start = line.find_first_not_of(" \t", i + 1);
+		if (start == std::string::npos || start + 3 >= line.size() || line[start + 2] != ':') continue;
+
+		int square = ParseSquare(line.c_str() + start);
+		if (square < 0) continue;
+		int value = std::atoi(line.c_str() + start + 3);
+		if (value > score) {
+			score = value;
+			bestMoves = 0;
+		}
+		if (value == score) bestMoves |= 1ULL << square;
+	}
+	return bestMoves != 0;
+}
+
+int RunEndgameBenchmark(const char* positionFile) {
+	std::vector<std::string> positions;
+	if (positionFile) {
+		std::ifstream file(positionFile);
+		if (!file) {
+			std::cerr << "Cannot open " << positionFile << "\n";
+			return 1;
+		}
+		std::string line;
+		while (std::getline(file, line)) {
+			if (!line.empty() && line[0] != '#' && line[0] != '%') positions.push_back(line);
+		}
+	}
+	else {
+		positions.assign(std::begin(ENDGAME_POSITIONS), std::end(ENDGAME_POSITIONS));
+	}
+
+	EndgameSolver solver;
+
+	std::cout << "Endgame benchmark\n";
+	std::cout << "  #  empties  move  score   time(ms)         nodes     knps\n";
+
+	double totalMs = 0.0;
+	double worstShortfallMs = 0.0;
+	int overTarget = 0;
+	int checked = 0;
+	int failed = 0;
+	uint64_t totalNodes = 0;
+	for (size_t i = 0; i < positions.size(); i++) {
+		Bitboard player, opponent;
+		if (!ParsePosition(positions[i], player, opponent)) {
+			std::cerr << "Invalid endgame position: " << positions[i] << "\n";
+			return 1;
+		}
+
+		int move = -1;
+		int score = 0;
+		solver.ClearTable();
+		auto start = std::chrono::steady_clock::now();
+		bool solved = solver.SolveRoot(player, opponent, false, move, score);
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		totalMs += ms;
+		totalNodes += solver.GetNodeCount();
+
+		// A wrong score is a solver bug, a different move is only wrong if it scores less
+		Bitboard expectedMoves;
+		int expectedScore;
+		std::string result;
+		if (ParseExpectedResult(positions[i], expectedMoves, expectedScore)) {
+			checked++;
+			if (solved && score == expectedScore && ((expectedMoves >> move) & 1)) {
+				result = "  ok";
+			}
+			else {
+				failed++;
+				result = "  FAIL, expected " + SquareName(LowestBitIndex(expectedMoves)) + " " + std::to_string(expectedScore);
+			}
+		}
+
+		int empties = PopCount(~(player | opponent));
+		bool slow = empties <= 20 && ms > ENDGAME_TARGET_MS;
+		if (slow) {
+			overTarget++;
+			worstShortfallMs = std::max(worstShortfallMs, ms - ENDGAME_TARGET_MS);
+		}
+
+		std::cout << std::setw(3) << i + 1
+			<< std::setw(9) << empties
+			<< std::setw(6) << (solved ? SquareName(move) : std::string("--"))
+			<< std::setw(7) << score
+			<< std::setw(11) << std::fixed << std::setprecision(1) << ms
+			<< std::setw(14) << solver.GetNodeCount()
+			<< std::setw(9) << static_cast<uint64_t>(solver.GetNodeCount() / std::max(ms, 1.0))
+			<< result << (slow ? "  over target" : "") << "\n";
+	}
+
+	std::cout << "total" << std::setw(28) << std::fixed << std::setprecision(1) << totalMs
+		<< std::setw(14) << totalNodes
+		<< std::setw(9) << static_cast<uint64_t>(totalNodes / std::max(totalMs, 1.0)) << "\n";
+
+	if (overTarget > 0) {
+		std::cout << overTarget << " position(s) with 20 or fewer empties over the " << std::setprecision(0) << ENDGAME_TARGET_MS
+			<< " ms target, worst by " << worstShortfallMs << " ms\n";
+	}
+	else {
+		std::cout << "All positions with 20 or fewer empties within the " << std::setprecision(0) << ENDGAME_TARGET_MS << " ms target\n";
+	}
+
+	if (checked > 0) {
+		std::cout << checked - failed << " of " << checked << " position(s) match the expected result\n";
+	}
+	return (failed > 0) ? 1 : 0;
+}
+
+int RunSmpBenchmark(int maxThreads, int depth) {
+	if (maxThreads < 1) maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+	if (maxThreads < 1) maxThreads = 1;
+
+	AI ai;
+	ai.SetLimits({ depth, 0, 0, 0, 0, false, false });
+
+	std::cout << "Lazy SMP benchmark, depth " << depth << "\n";
+	std::cout << "threads   time(ms)        nodes     knps  speedup\n";
+
+	double baseTime = 0.0;
+	for (int threads = 1; threads <= maxThreads; threads++) {
+		ai.SetThreadCount(threads);
+
+		double totalMs = 0.0;
+		uint64_t totalNodes = 0;
+		for (const char* moves : BENCH_POSITIONS) {
+			Board board;
+			board.Reset();
+			char player = BLACK_PIECE;
+			if (!PlayMoveSequence(board, player, moves)) {
+				std::cerr << "Invalid benchmark position: " << moves << "\n";
+				return 1;
+			}
+
+			// Every position starts from an empty table, so the runs are comparable
+			ai.ClearTables();
+			auto start = std::chrono::steady_clock::now();
+			ai.MakeMove(board, player);
+			totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			totalNodes += ai.GetNodeCount();
+		}
+
+		if (threads == 1) baseTime = totalMs;
+		std::cout << std::setw(7) << threads
+			<< std::setw(11) << std::fixed << std::setprecision(1) << totalMs
+			<< std::setw(13) << totalNodes
+			<< std::setw(9) << static_cast<uint64_t>(totalNodes / std::max(totalMs, 1.0))
+			<< std::setw(9) << std::setprecision(2) << baseTime / std::max(totalMs, 1.0) << "\n";
+	}
+
+	return 0;
+}
+
+// One move of a benchmark game, replayed through the network state
+struct NetworkBenchMove {
+	int square;
+	Bitboard flips;
+	int color;
+	bool blackToMove;       // Side to move after the move
+};
+
+int RunNetworkBenchmark(int positions, unsigned seed) {
+	std::mt19937 random(seed);
+	std::vector<std::vector<NetworkBenchMove>> games;
+	int total = 0;
+	while (total < positions) {
+		games.emplace_back();
+		Board board;
+		board.Reset();
+		char player = BLACK_PIECE;
+		while (total < positions) {
+			Bitboard moves = board.GetValidMoves(player);
+			if (!moves) {
+				player = OpponentOf(player);
+				moves = board.GetValidMoves(player);
+				if (!moves) break;
+			}
+
+			std::vector<int> squares;
+			while (moves) squares.push_back(PopLowestBit(moves));
+			int square = squares[random() % squares.size()];
+			Bitboard flips = GetFlipsMask(square, board.Pieces(player), board.Pieces(OpponentOf(player)));
+			board.MakeMove(square / BOARD_SIZE, square % BOARD_SIZE, player);
+			player = OpponentOf(player);
+			games.back().push_back({ square, flips, (player == WHITE_PIECE) ? 1 : 2, player == BLACK_PIECE });
+			total++;
+		}
+	}
+
+	NnueEvaluator network;
+	network.RandomizeWeights(seed);
+	std::unique_ptr<NnueState> state(new NnueState());
+
+	// Reference scores: portable kernel, accumulators recomputed from scratch for every position
+	network.SetKernel(SimdKernel::SCALAR);
+	std::vector<int> reference;
+	for (const auto& game : games) {
+		Board board;
+		board.Reset();
+		for (const NetworkBenchMove& move : game) {
+			board.MakeMove(move.square / BOARD_SIZE, move.square % BOARD_SIZE, (move.color == 1) ? BLACK_PIECE : WHITE_PIECE);
+			network.ComputeState(board.Pieces(BLACK_PIECE), board.Pieces(WHITE_PIECE), *state);
+			reference.push_back(network.Evaluate(*state, move.blackToMove));
+		}
+	}
+
+	std::cout << "Network benchmark, " << total << " positions, " << NNUE_HIDDEN << "x2-" << NNUE_LAYER1 << "-1\n";
+	std::cout << "kernel    updates/s     evals/s  update+eval/s  scores\n";
+
+	const int rounds = 10;
+	bool allMatch = true;
+	for (SimdKernel kernel : { SimdKernel::SCALAR, SimdKernel::SSE41, SimdKernel::AVX2 }) {
+		if (!network.SetKernel(kernel)) {
+			std::cout << std::left << std::setw(8) << GetSimdKernelName(kernel) << std::right << "  not supported by this CPU\n";
+			continue;
+		}
+
+		// Incremental updates along the games, checked against the reference
+		bool match = true;
+		size_t index = 0;
+		for (const auto& game : games) {
+			Board board;
+			board.Reset();
+			network.ComputeState(board.Pieces(BLACK_PIECE), board.Pieces(WHITE_PIECE), *state);
+			for (const NetworkBenchMove& move : game) {
+				network.MakeMove(*state, move.square, move.flips, move.color);
+				if (network.Evaluate(*state, move.blackToMove) != reference[index++]) match = false;
+			}
+		}
+		allMatch = allMatch && match;
+
+		int64_t checksum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int round = 0; round < rounds; round++) {
+			for (const auto& game : games) {
+				state->top = 0;
+				for (const NetworkBenchMove& move : game) network.MakeMove(*state, move.square, move.flips, move.color);
+				checksum += state->accumulators[state->top][0][0];
+			}
+		}
+		double updateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		start = std::chrono::steady_clock::now();
+		for (int round = 0; round < rounds; round++) {
+			for (const auto& game : games) {
+				state->top = 0;
+				for (const NetworkBenchMove& move : game) {
+					network.MakeMove(*state, move.square, move.flips, move.color);
+					checksum += network.Evaluate(*state, move.blackToMove);
+					network.UndoMove(*state);
+				}
+			}
+		}
+		double bothMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		start = std::chrono::steady_clock::now();
+		for (int round = 0; round < rounds; round++) {
+			for (int i = 0; i < total; i++) checksum += network.Evaluate(*state, (i & 1) != 0);
+		}
+		double evalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		double calls = static_cast<double>(rounds) * total;
+		std::cout << std::left << std::setw(8) << GetSimdKernelName(kernel) << std::right
+			<< std::setw(13) << static_cast<uint64_t>(calls * 1000.0 / std::max(updateMs, 0.001))
+			<< std::setw(12) << static_cast<uint64_t>(calls * 1000.0 / std::max(evalMs, 0.001))
+			<< std::setw(15) << static_cast<uint64_t>(calls * 1000.0 / std::max(bothMs, 0.001))
+			<< "  " << (match ? "ok" : "MISMATCH") << "  (checksum " << checksum << ")\n";
+	}
+
+	return allMatch ? 0 : 1;
+}
+
+int RunNetworkSearchCheck(const char* networkPath, int positions, unsigned seed) {
+	AI ai;
+	if (!ai.LoadNetwork(networkPath)) {
+		std::cerr << "Cannot load a network from " << networkPath << "\n";
+		return 1;
+	}
+
+	// Several threads, so the helpers' states are checked too; a shallow budget keeps the check fast
+	const int threads = 4;
+	ai.SetThreadCount(threads);
+	ai.SetLimits({ 6, 0, 20000, 0, 0, false, false });
+	ai.SetSeed(seed);
+	ai.SetStateCheck(true);
+
+	// Searches every position of random games, passes included
+	std::mt19937 random(seed);
+	int searched = 0;
+	while (searched < positions) {
+		Board board;
+		board.Reset();
+		char player = BLACK_PIECE;
+		while (searched < positions) {
+			Bitboard moves = board.GetValidMoves(player);
+			if (!moves) {
+				player = OpponentOf(player);
+				moves = board.GetValidMoves(player);
+				if (!moves) break;
+			}
+
+			ai.MakeMove(board, player);
+			searched++;
+
+			std::vector<int> squares;
+			while (moves) squares.push_back(PopLowestBit(moves));
+			int square = squares[random() % squares.size()];
+			board.MakeMove(square / BOARD_SIZE, square % BOARD_SIZE, player);
+			player = OpponentOf(player);
+		}
+	}
+
+	uint64_t checks, mismatches;
+	ai.GetStateCheckCounts(checks, mismatches);
+	std::cout << "Searched " << searched << " positions with " << networkPath << " on " << threads << " threads: "
+		<< checks << " moves made or taken back, " << mismatches << " accumulator mismatches\n";
+	return (mismatches == 0 && checks > 0) ? 0 : 1;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+// Headless benchmarks (console output only, no SDL)
+
+// Searches a fixed set of positions to a fixed depth with 1..maxThreads threads and
+// reports time-to-depth, nodes/sec and the speedup over one thread.
+int RunSmpBenchmark(int maxThreads, int depth);
+
+// Solves endgame positions exactly and reports solve time and nodes/sec. Positions with 20 or
+// fewer empties that take longer than the 1 second target are marked, with the worst shortfall.
+// Positions come from the built-in FFO set or from a file with one "<64 cells> <side>" line each
+// (X = black, O = white, - = empty, cells from a1 to h8 row by row, side X or O), the format of the FFO test suite.
+// A line may end with the expected results as in the suite's obf files ("; A2:+38"): the solved score
+// must equal the best listed one and the move must be listed with it. Returns 1 if any position fails.
+int RunEndgameBenchmark(const char* positionFile);
+
+// Plays random games with random network weights and reports incremental accumulator updates
+// and evaluations per second for every inference kernel the CPU supports. Also checks that all
+// kernels and a full recomputation give the same scores.
+int RunNetworkBenchmark(int positions, unsigned seed);
+
+// Loads a network file into the AI and searches positions of random games on several threads, checking
+// after every move made and taken back that each worker's accumulators match a full recomputation.
+int RunNetworkSearchCheck(const char* networkPath, int positions, unsigned seed);
@@ -0,0 +1,439 @@
+#include "Board.h"
+#ifdef CPU_X86
+#include <immintrin.h>
+#endif
+
+// Masks that stop a shift from wrapping around to the other side of the board
+static const Bitboard NOT_FIRST_COL = 0xFEFEFEFEFEFEFEFEULL;
+static const Bitboard NOT_LAST_COL = 0x7F7F7F7F7F7F7F7FULL;
+
+// Shifts every disc one step in a direction (0..7)
+// E, W, S, N, SE, SW, NE, NW
+template <int DIR>
+static inline Bitboard Shift(Bitboard b) {
+	switch (DIR) {
+	case 0: return (b << 1) & NOT_FIRST_COL;
+	case 1: return (b >> 1) & NOT_LAST_COL;
+	case 2: return b << 8;
+	case 3: return b >> 8;
+	case 4: return (b << 9) & NOT_FIRST_COL;
+	case 5: return (b << 7) & NOT_LAST_COL;
+	case 6: return (b >> 7) & NOT_FIRST_COL;
+	default: return (b >> 9) & NOT_LAST_COL;
+	}
+}
+
+// Flood from the player's discs over opponent runs, then step onto an empty cell
+template <int DIR>
+static inline Bitboard MovesInDirection(Bitboard player, Bitboard opponent, Bitboard empty) {
+	Bitboard run = Shift<DIR>(player) & opponent;
+	run |= Shift<DIR>(run) & opponent;
+	run |= Shift<DIR>(run) & opponent;
+	run |= Shift<DIR>(run) & opponent;
+	run |= Shift<DIR>(run) & opponent;
+	run |= Shift<DIR>(run) & opponent;
+	return Shift<DIR>(run) & empty;
+}
+
+// Opponent run starting next to the origin, kept only when one of the player's discs closes it
+template <int DIR>
+static inline Bitboard FlipsInDirection(Bitboard origin, Bitboard player, Bitboard opponent) {
+	Bitboard run = 0;
+	Bitboard cursor = Shift<DIR>(origin);
+
+	while (cursor & opponent) {
+		run |= cursor;
+		cursor = Shift<DIR>(cursor);
+	}
+
+	return (cursor & player) ? run : 0;
+}
+
+static Bitboard GetMovesMaskScalar(Bitboard player, Bitboard opponent) {
+	Bitboard empty = ~(player | opponent);
+
+	return MovesInDirection<0>(player, opponent, empty) | MovesInDirection<1>(player, opponent, empty)
+		| MovesInDirection<2>(player, opponent, empty) | MovesInDirection<3>(player, opponent, empty)
+		| MovesInDirection<4>(player, opponent, empty) | MovesInDirection<5>(player, opponent, empty)
+		| MovesInDirection<6>(player, opponent, empty) | MovesInDirection<7>(player, opponent, empty);
+}
+
+static Bitboard GetFlipsMaskScalar(int square, Bitboard player, Bitboard opponent) {
+	Bitboard origin = 1ULL << square;
+
+	return FlipsInDirection<0>(origin, player, opponent) | FlipsInDirection<1>(origin, player, opponent)
+		| FlipsInDirection<2>(origin, player, opponent) | FlipsInDirection<3>(origin, player, opponent)
+		| FlipsInDirection<4>(origin, player, opponent) | FlipsInDirection<5>(origin, player, opponent)
+		| FlipsInDirection<6>(origin, player, opponent) | FlipsInDirection<7>(origin, player, opponent);
+}
+
+// Squares seen from each square, one ray per direction. The SIMD kernels keep one direction
+// per 64-bit lane with the shifts 1, 8, 9, 7: E, S, SE, SW going up and W, N, NW, NE going down.
+struct SquareRays {
+	Bitboard up[4];
+	Bitboard down[4];
+};
+
+static SquareRays squareRays[BOARD_CELLS];
+
+static void InitSquareRays() {
+	static const int upSteps[4][2] = { { 0, 1 }, { 1, 0 }, { 1, 1 }, { 1, -1 } };
+	for (int square = 0; square < BOARD_CELLS; square++) {
+		for (int lane = 0; lane < 4; lane++) {
+			for (int sign = 1; sign >= -1; sign -= 2) {
+				Bitboard ray = 0;
+				int row = square / BOARD_SIZE + sign * upSteps[lane][0];
+				int col = square % BOARD_SIZE + sign * upSteps[lane][1];
+				for (; row >= 0 && row < BOARD_SIZE && col >= 0 && col < BOARD_SIZE; row += sign * upSteps[lane][0], col += sign * upSteps[lane][1]) {
+					ray |= SquareMask(row, col);
+				}
+				if (sign > 0) squareRays[square].up[lane] = ray;
+				else squareRays[square].down[lane] = ray;
+			}
+		}
+	}
+}
+
+#ifdef CPU_X86
+#define EDGE_COLUMNS_MASK   0x7E7E7E7E7E7E7E7ELL    // Horizontal and diagonal runs never include the edge columns
+
+// AVX2: the 8 directions in two registers, left shifts for the lanes going up and right shifts for the others.
+// Masking the opponent's edge columns once keeps the shifted runs from wrapping around a row.
+TARGET_AVX2 static Bitboard GetMovesMaskAvx2(Bitboard player, Bitboard opponent) {
+	const __m256i shifts = _mm256_set_epi64x(7, 9, 8, 1);
+	const __m256i doubleShifts = _mm256_add_epi64(shifts, shifts);
+	__m256i pp = _mm256_set1_epi64x(static_cast<long long>(player));
+	__m256i oo = _mm256_and_si256(_mm256_set1_epi64x(static_cast<long long>(opponent)),
+		_mm256_set_epi64x(EDGE_COLUMNS_MASK, EDGE_COLUMNS_MASK, -1, EDGE_COLUMNS_MASK));
+
+	// Opponent runs next to the player's discs: two single steps, then two steps over opponent pairs (6 discs)
+	__m256i up = _mm256_and_si256(oo, _mm256_sllv_epi64(pp, shifts));
+	__m256i down = _mm256_and_si256(oo, _mm256_srlv_epi64(pp, shifts));
+	up = _mm256_or_si256(up, _mm256_and_si256(oo, _mm256_sllv_epi64(up, shifts)));
+	down = _mm256_or_si256(down, _mm256_and_si256(oo, _mm256_srlv_epi64(down, shifts)));
+
+	__m256i pairsUp = _mm256_and_si256(oo, _mm256_sllv_epi64(oo, shifts));
+	__m256i pairsDown = _mm256_srlv_epi64(pairsUp, shifts);
+	up = _mm256_or_si256(up, _mm256_and_si256(pairsUp, _mm256_sllv_epi64(up, doubleShifts)));
+	down = _mm256_or_si256(down, _mm256_and_si256(pairsDown, _mm256_srlv_epi64(down, doubleShifts)));
+	up = _mm256_or_si256(up, _mm256_and_si256(pairsUp, _mm256_sllv_epi64(up, doubleShifts)));
+	down = _mm256_or_si256(down, _mm256_and_si256(pairsDown, _mm256_srlv_epi64(down, doubleShifts)));
+
+	__m256i moves = _mm256_or_si256(_mm256_sllv_epi64(up, shifts), _mm256_srlv_epi64(down, shifts));
+	__m128i half = _mm_or_si128(_mm256_castsi256_si128(moves), _mm256_extracti128_si256(moves, 1));
+	half = _mm_or_si128(half, _mm_unpackhi_epi64(half, half));
+	return static_cast<Bitboard>(_mm_cvtsi128_si64(half)) & ~(player | opponent);
+}
+
+// Up rays: the opponent run ends at the lowest square of the ray that is not an opponent disc.
+// Down rays: the nearest such square is the highest one, found by smearing the squares down the ray.
+// The run flips when that square holds a player disc.
+TARGET_AVX2 static Bitboard GetFlipsMaskAvx2(int square, Bitboard player, Bitboard opponent) {
+	const __m256i shifts = _mm256_set_epi64x(7, 9, 8, 1);
+	const __m256i zero = _mm256_setzero_si256();
+	__m256i pp = _mm256_set1_epi64x(static_cast<long long>(player));
+	__m256i oo = _mm256_set1_epi64x(static_cast<long long>(opponent));
+
+	__m256i rays = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(squareRays[square].up));
+	__m256i outflank = _mm256_andnot_si256(oo, rays);
+	outflank = _mm256_and_si256(_mm256_and_si256(outflank, _mm256_sub_epi64(zero, outflank)), pp);
+	__m256i flips = _mm256_and_si256(rays, _mm256_add_epi64(outflank, _mm256_set1_epi64x(-1)));
+	flips = _mm256_andnot_si256(_mm256_cmpeq_epi64(outflank, zero), flips);
+
+	rays = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(squareRays[square].down));
+	__m256i stops = _mm256_andnot_si256(oo, rays);
+	__m256i smear = _mm256_or_si256(stops, _mm256_srlv_epi64(stops, shifts));
+	smear = _mm256_or_si256(smear, _mm256_srlv_epi64(smear, _mm256_slli_epi64(shifts, 1)));
+	smear = _mm256_or_si256(smear, _mm256_srlv_epi64(smear, _mm256_slli_epi64(shifts, 2)));
+	outflank = _mm256_and_si256(_mm256_andnot_si256(_mm256_srlv_epi64(smear, shifts), stops), pp);
+	__m256i downFlips = _mm256_andnot_si256(_mm256_cmpeq_epi64(outflank, zero), _mm256_andnot_si256(smear, rays));
+	flips = _mm256_or_si256(flips, downFlips);
+
+	__m128i half = _mm_or_si128(_mm256_castsi256_si128(flips), _mm256_extracti128_si256(flips, 1));
+	half = _mm_or_si128(half, _mm_unpackhi_epi64(half, half));
+	return static_cast<Bitboard>(_mm_cvtsi128_si64(half));
+}
+
+// SSE4.1 has no per-lane shifts, so the registers pair each direction going up (low lane) with its
+// mirror going down (high lane). Turning the high lane upside down makes N, NE and NW left shifts
+// like S, SE and SW; E and W share a register with both shifts blended.
+TARGET_SSE41 static inline __m128i MirrorHighLane(__m128i x) {
+	return _mm_shuffle_epi8(x, _mm_set_epi8(8, 9, 10, 11, 12, 13, 14, 15, 7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+template <int SHIFT, bool EAST_WEST>
+TARGET_SSE41 static inline __m128i ShiftPair(__m128i x) {
+	return EAST_WEST ? _mm_blend_epi16(_mm_slli_epi64(x, SHIFT), _mm_srli_epi64(x, SHIFT), 0xF0) : _mm_slli_epi64(x, SHIFT);
+}
+
+template <int SHIFT, bool EAST_WEST>
+TARGET_SSE41 static inline __m128i MovesPair(__m128i pp, __m128i oo) {
+	__m128i run = _mm_and_si128(oo, ShiftPair<SHIFT, EAST_WEST>(pp));
+	run = _mm_or_si128(run, _mm_and_si128(oo, ShiftPair<SHIFT, EAST_WEST>(run)));
+	__m128i pairs = _mm_and_si128(oo, ShiftPair<SHIFT, EAST_WEST>(oo));
+	run = _mm_or_si128(run, _mm_and_si128(pairs, ShiftPair<2 * SHIFT, EAST_WEST>(run)));
+	run = _mm_or_si128(run, _mm_and_si128(pairs, ShiftPair<2 * SHIFT, EAST_WEST>(run)));
+	return ShiftPair<SHIFT, EAST_WEST>(run);
+}
+
+TARGET_SSE41 static Bitboard GetMovesMaskSse41(Bitboard player, Bitboard opponent) {
+	const __m128i edges = _mm_set1_epi64x(EDGE_COLUMNS_MASK);
+	__m128i pp = _mm_set1_epi64x(static_cast<long long>(player));
+	__m128i oo = _mm_set1_epi64x(static_cast<long long>(opponent));
+	__m128i horizontal = MovesPair<1, true>(pp, _mm_and_si128(oo, edges));
+
+	__m128i ppMirror = MirrorHighLane(pp);
+	__m128i ooMirror = MirrorHighLane(oo);
+	__m128i ooMirrorEdges = _mm_and_si128(ooMirror, edges);
+	__m128i vertical = _mm_or_si128(MovesPair<8, false>(ppMirror, ooMirror),
+		_mm_or_si128(MovesPair<9, false>(ppMirror, ooMirrorEdges), MovesPair<7, false>(ppMirror, ooMirrorEdges)));
+
+	__m128i moves = _mm_or_si128(horizontal, MirrorHighLane(vertical));
+	moves = _mm_or_si128(moves, _mm_unpackhi_epi64(moves, moves));
+	return static_cast<Bitboard>(_mm_cvtsi128_si64(moves)) & ~(player | opponent);
+}
+
+// Same rules as the AVX2 kernel, on two lanes
+TARGET_SSE41 static inline __m128i FlipsUpPair(__m128i pp, __m128i oo, __m128i rays) {
+	const __m128i zero = _mm_setzero_si128();
+	__m128i outflank = _mm_andnot_si128(oo, rays);
+	outflank = _mm_and_si128(_mm_and_si128(outflank, _mm_sub_epi64(zero, outflank)), pp);
+	__m128i flips = _mm_and_si128(rays, _mm_add_epi64(outflank, _mm_set1_epi64x(-1)));
+	return _mm_andnot_si128(_mm_cmpeq_epi64(outflank, zero), flips);
+}
+
+TARGET_SSE41 static Bitboard GetFlipsMaskSse41(int square, Bitboard player, Bitboard opponent) {
+	const SquareRays& rays = squareRays[square];
+	const SquareRays& mirrorRays = squareRays[square ^ 56];     // Same square with the rows reversed
+	__m128i pp = _mm_set1_epi64x(static_cast<long long>(player));
+	__m128i oo = _mm_set1_epi64x(static_cast<long long>(opponent));
+	__m128i ppMirror = MirrorHighLane(pp);
+	__m128i ooMirror = MirrorHighLane(oo);
+
+	// S/N, SE/NE and SW/NW are all up rays once the high lane is upside down
+	__m128i vertical = FlipsUpPair(ppMirror, ooMirror, _mm_set_epi64x(static_cast<long long>(mirrorRays.up[1]), static_cast<long long>(rays.up[1])));
+	vertical = _mm_or_si128(vertical, FlipsUpPair(ppMirror, ooMirror, _mm_set_epi64x(static_cast<long long>(mirrorRays.up[2]), static_cast<long long>(rays.up[2]))));
+	vertical = _mm_or_si128(vertical, FlipsUpPair(ppMirror, ooMirror, _mm_set_epi64x(static_cast<long long>(mirrorRays.up[3]), static_cast<long long>(rays.up[3]))));
+
+	// E in the low lane as an up ray, W in the high lane smeared down the row
+	__m128i rowRays = _mm_set_epi64x(static_cast<long long>(rays.down[0]), static_cast<long long>(rays.up[0]));
+	__m128i stops = _mm_andnot_si128(oo, rowRays);
+	__m128i smear = _mm_or_si128(stops, _mm_srli_epi64(stops, 1));
+	smear = _mm_or_si128(smear, _mm_srli_epi64(smear, 2));
+	smear = _mm_or_si128(smear, _mm_srli_epi64(smear, 4));
+	__m128i outflank = _mm_and_si128(_mm_andnot_si128(_mm_srli_epi64(smear, 1), stops), pp);
+	__m128i west = _mm_andnot_si128(_mm_cmpeq_epi64(outflank, _mm_setzero_si128()), _mm_andnot_si128(smear, rowRays));
+	__m128i horizontal = _mm_blend_epi16(FlipsUpPair(pp, oo, rowRays), west, 0xF0);
+
+	__m128i flips = _mm_or_si128(horizontal, MirrorHighLane(vertical));
+	flips = _mm_or_si128(flips, _mm_unpackhi_epi64(flips, flips));
+	return static_cast<Bitboard>(_mm_cvtsi128_si64(flips));
+}
+#endif
+
+typedef Bitboard (*MovesFunction)(Bitboard player, Bitboard opponent);
+typedef Bitboard (*FlipsFunction)(int square, Bitboard player, Bitboard opponent);
+
+// Constant-initialized, so the portable kernels already work for other files' static initializers
+static MovesFunction movesKernel = GetMovesMaskScalar;
+static FlipsFunction flipsKernel = GetFlipsMaskScalar;
+static SimdKernel moveGenKernel = SimdKernel::SCALAR;
+
+bool SetMoveGenKernel(SimdKernel kernel) {
+	if (!IsSimdKernelSupported(kernel)) return false;
+
+	movesKernel = GetMovesMaskScalar;
+	flipsKernel = GetFlipsMaskScalar;
+#ifdef CPU_X86
+	if (kernel == SimdKernel::AVX2) {
+		movesKernel = GetMovesMaskAvx2;
+		flipsKernel = GetFlipsMaskAvx2;
+	}
+	else if (kernel == SimdKernel::SSE41) {
+		movesKernel = GetMovesMaskSse41;
+		flipsKernel = GetFlipsMaskSse41;
+	}
+#endif
+	moveGenKernel = kernel;
+	return true;
+}
+
+SimdKernel GetMoveGenKernel() {
+	return moveGenKernel;
+}
+
+static bool InitMoveGen() {
+	InitSquareRays();
+	return SetMoveGenKernel(GetBestSimdKernel());
+}
+
+static const bool moveGenReady = InitMoveGen();
+
+Bitboard GetMovesMask(Bitboard player, Bitboard opponent) {
+	return movesKernel(player, opponent);
+}
+
+Bitboard GetFlipsMask(int square, Bitboard player, Bitboard opponent) {
+	return flipsKernel(square, player, opponent);
+}
+
+// Zobrist keys, one table per byte of each color mask
+static uint64_t zobristKeys[16][256];
+
+static bool InitZobristKeys() {
+	// SplitMix64 with a fixed seed, so hashes are identical on every run
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	for (int table = 0; table < 16; table++) {
+		for (int value = 0; value < 256; value++) {
+			uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+			zobristKeys[table][value] = z ^ (z >> 31);
+		}
+	}
+	return true;
+}
+
+static const bool zobristReady = InitZobristKeys();
+
+uint64_t HashPosition(Bitboard player, Bitboard opponent) {
+	uint64_t hash = 0;
+	for (int i = 0; i < 8; i++) {
+		hash ^= zobristKeys[i][(player >> (i * 8)) & 0xFF];
+		hash ^= zobristKeys[8 + i][(opponent >> (i * 8)) & 0xFF];
+	}
+	return hash;
+}
+
+static inline Bitboard FlipRows(Bitboard b) {
+	b = ((b >> 8) & 0x00FF00FF00FF00FFULL) | ((b & 0x00FF00FF00FF00FFULL) << 8);
+	b = ((b >> 16) & 0x0000FFFF0000FFFFULL) | ((b & 0x0000FFFF0000FFFFULL) << 16);
+	return (b >> 32) | (b << 32);
+}
+
+static inline Bitboard MirrorColumns(Bitboard b) {
+	b = ((b >> 1) & 0x5555555555555555ULL) | ((b & 0x5555555555555555ULL) << 1);
+	b = ((b >> 2) & 0x3333333333333333ULL) | ((b & 0x3333333333333333ULL) << 2);
+	return ((b >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((b & 0x0F0F0F0F0F0F0F0FULL) << 4);
+}
+
+// Swaps rows and columns (square row * 8 + col goes to col * 8 + row)
+static inline Bitboard Transpose(Bitboard b) {
+	Bitboard t = 0x0F0F0F0F00000000ULL & (b ^ (b << 28));
+	b ^= t ^ (t >> 28);
+	t = 0x3333000033330000ULL & (b ^ (b << 14));
+	b ^= t ^ (t >> 14);
+	t = 0x5500550055005500ULL & (b ^ (b << 7));
+	return b ^ t ^ (t >> 7);
+}
+
+Bitboard TransformBitboard(Bitboard b, int symmetry) {
+	if (symmetry & 4) b = Transpose(b);
+	if (symmetry & 2) b = FlipRows(b);
+	if (symmetry & 1) b = MirrorColumns(b);
+	return b;
+}
+
+int TransformSquare(int square, int symmetry) {
+	return LowestBitIndex(TransformBitboard(1ULL << square, symmetry));
+}
+
+int CanonicalPosition(Bitboard player, Bitboard opponent, Bitboard& canonicalPlayer, Bitboard& canonicalOpponent) {
+	int best = 0;
+	canonicalPlayer = player;
+	canonicalOpponent = opponent;
+
+	for (int symmetry = 1; symmetry < BOARD_SYMMETRIES; symmetry++) {
+		Bitboard p = TransformBitboard(player, symmetry);
+		Bitboard o = TransformBitboard(opponent, symmetry);
+		if (p < canonicalPlayer || (p == canonicalPlayer && o < canonicalOpponent)) {
+			canonicalPlayer = p;
+			canonicalOpponent = o;
+			best = symmetry;
+		}
+	}
+	return best;
+}
+
+void Board::Reset() {
+	int center = BOARD_SIZE / 2;
+	black = SquareMask(center - 1, center) | SquareMask(center, center - 1);
+	white = SquareMask(center - 1, center - 1) | SquareMask(center, center);
+}
+
+void Board::Clear() {
+	black = 0;
+	white = 0;
+}
+
+char Board::GetPiece(int row, int col) const {
+	Bitboard mask = SquareMask(row, col);
+	if (black & mask) return BLACK_PIECE;
+	if (white & mask) return WHITE_PIECE;
+	return EMPTY_PIECE;
+}
+
+void Board::SetPiece(int row, int col, char piece) {
+	Bitboard mask = SquareMask(row, col);
+	black &= ~mask;
+	white &= ~mask;
+
+	if (piece == BLACK_PIECE) black |= mask;
+	else if (piece == WHITE_PIECE) white |= mask;
+}
+
+bool Board::IsValidMove(int row, int col, char player) const {
+	if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE) return false;
+	if (!(Empties() & SquareMask(row, col))) return false;
+
+	return GetFlipsMask(row * BOARD_SIZE + col, Pieces(player), Pieces(OpponentOf(player))) != 0;
+}
+
+Bitboard Board::GetValidMoves(char player) const {
+	return GetMovesMask(Pieces(player), Pieces(OpponentOf(player)));
+}
+
+Bitboard Board::MakeMove(int row, int col, char player) {
+	if (!(Empties() & SquareMask(row, col))) return 0;
+
+	Bitboard& own = Pieces(player);
+	Bitboard& other = Pieces(OpponentOf(player));
+	Bitboard flips = GetFlipsMask(row * BOARD_SIZE + col, own, other);
+	if (!flips) return 0;
+
+	ToggleMove(own, other, SquareMask(row, col), flips);
+	return flips;
+}
+
+int ParseSquare(const char* text) {
+	char column = text[0];
+	char row = text[1];
+	if (column >= 'A' && column <= 'Z') column = column - 'A' + 'a';
+	if (column < 'a' || column >= 'a' + BOARD_SIZE || row < '1' || row >= '1' + BOARD_SIZE) return -1;
+
+	return (row - '1') * BOARD_SIZE + (column - 'a');
+}
+
+std::string SquareName(int square) {
+	std::string name;
+	name += static_cast<char>('a' + square % BOARD_SIZE);
+	name += static_cast<char>('1' + square / BOARD_SIZE);
+	return name;
+}
+
+bool PlayMoveSequence(Board& board, char& player, const char* moves, std::vector<uint8_t>* played) {
+	for (const char* cursor = moves; cursor[0]; cursor += 2) {
+		int square = ParseSquare(cursor);      // Also rejects a trailing half move, its row is the terminator
+		if (square < 0) return false;
+
+		// A side without moves passes implicitly
+		if (!board.GetValidMoves(player)) player = OpponentOf(player);
+
+		if (!board.MakeMove(square / BOARD_SIZE, square % BOARD_SIZE, player)) return false;
+		player = OpponentOf(player);
+		if (played) played->push_back(static_cast<uint8_t>(square));
+	}
+
+	if (!board.GetValidMoves(player)) player = OpponentOf(player);
+	return true;
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include "CpuFeatures.h"
+
+// Bitboard rules engine (no SDL dependency, shared by the game and the AI)
+//
+// Square index = row * BOARD_SIZE + col, bit 0 is the top-left cell (row 0, col 0)
+
+#define BOARD_SIZE      8
+#define BOARD_CELLS     (BOARD_SIZE * BOARD_SIZE)
+
+#define EMPTY_PIECE     ' '
+#define BLACK_PIECE     'B'
+#define WHITE_PIECE     'W'
+
+typedef uint64_t Bitboard;
+
+// Bit manipulation helpers
+inline int PopCount(Bitboard b) {
+#if defined(_MSC_VER) && defined(_M_X64)
+	return static_cast<int>(__popcnt64(b));
+#elif defined(__GNUC__)
+	return __builtin_popcountll(b);
+#else
+	b = b - ((b >> 1) & 0x5555555555555555ULL);
+	b = (b & 0x3333333333333333ULL) + ((b >> 2) & 0x3333333333333333ULL);
+	b = (b + (b >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return static_cast<int>((b * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+inline int LowestBitIndex(Bitboard b) {
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long index;
+	_BitScanForward64(&index, b);
+	return static_cast<int>(index);
+#elif defined(__GNUC__)
+	return __builtin_ctzll(b);
+#else
+	return PopCount((b & (0 - b)) - 1);
+#endif
+}
+
+// Removes the lowest set bit from the mask and returns its square index
+inline int PopLowestBit(Bitboard& b) {
+	int index = LowestBitIndex(b);
+	b &= b - 1;
+	return index;
+}
+
+inline Bitboard SquareMask(int row, int col) {
+	return 1ULL << (row * BOARD_SIZE + col);
+}
+
+inline char OpponentOf(char player) {
+	return (player == BLACK_PIECE) ? WHITE_PIECE : BLACK_PIECE;
+}
+
+// Move generation on raw masks (side to move / side waiting)
+Bitboard GetMovesMask(Bitboard player, Bitboard opponent);
+Bitboard GetFlipsMask(int square, Bitboard player, Bitboard opponent);
+
+// Both functions run all 8 directions at once on AVX2 (4 per register) or SSE4.1 (2 per register)
+// when the CPU has them. The best kernel is picked at startup; the others can be forced for
+// testing, but not while another thread is generating moves.
+bool SetMoveGenKernel(SimdKernel kernel);      // Returns false if the CPU lacks the instructions
+SimdKernel GetMoveGenKernel();
+
+// The state transition of a move, shared by the board, the move stack and the searches: the mover
+// gains the placed disc and the flips, the other side loses the flips. Being XORs, applying the
+// same move again takes it back, so make and unmake are the same two instructions.
+inline void ToggleMove(Bitboard& player, Bitboard& opponent, Bitboard placed, Bitboard flips) {
+	player ^= placed | flips;
+	opponent ^= flips;
+}
+
+// Zobrist hash of a position (side to move / side waiting)
+uint64_t HashPosition(Bitboard player, Bitboard opponent);
+
+// Board symmetries (0..7): bit 2 = transpose, bit 1 = flip rows, bit 0 = mirror columns, applied in that order
+#define BOARD_SYMMETRIES    8
+
+Bitboard TransformBitboard(Bitboard b, int symmetry);
+int TransformSquare(int square, int symmetry);
+
+// Picks the symmetry giving the smallest (player, opponent) pair, so all 8 transformed
+// copies of a position share one key. Returns the symmetry used.
+int CanonicalPosition(Bitboard player, Bitboard opponent, Bitboard& canonicalPlayer, Bitboard& canonicalOpponent);
+
+// Board position: one 64-bit mask per color
+struct Board {
+	typedef Bitboard Bits;
+
+	Bitboard black = 0;
+	Bitboard white = 0;
+
+	void Reset();          // Standard starting position
+	void Clear();          // Empty board
+
+	Bitboard& Pieces(char player) { return (player == BLACK_PIECE) ? black : white; }
+	Bitboard Pieces(char player) const { return (player == BLACK_PIECE) ? black : white; }
+	Bitboard Empties() const { return ~(black | white); }
+
+	// Query API used by the UI
+	char GetPiece(int row, int col) const;
+	void SetPiece(int row, int col, char piece);
+	int CountPieces(char player) const { return PopCount(Pieces(player)); }
+	bool IsFull() const { return (black | white) == ~0ULL; }
+
+	// Rules
+	bool IsValidMove(int row, int col, char player) const;
+	Bitboard GetValidMoves(char player) const;
+	Bitboard MakeMove(int row, int col, char player);   // Returns the flipped discs, 0 if the move is illegal
+};
+
+// Moves played on a board with their flips, for takeback. Undoing or replaying a move is one
+// ToggleMove, nothing is generated again. Every move adds a disc, so a game holds at most Capacity
+// moves and the stack never allocates. Undone moves stay above the top for Redo until the next Push.
+template <typename BoardType, int Capacity>
+class MoveStack {
+public:
+	typedef typename BoardType::Bits Bits;
+
+	struct Entry {
+		Bits flips;
+		int square;
+		char player;
+	};
+
+	void Clear() {
+		top = 0;
+		end = 0;
+	}
+
+	int GetCount() const { return top; }
+	bool CanUndo() const { return top > 0; }
+	bool CanRedo() const { return top < end; }
+
+	// Records a move already made on the board (flips as returned by MakeMove)
+	void Push(int square, Bits flips, char player) {
+		if (top == Capacity) return;
+		entries[top++] = { flips, square, player };
+		end = top;
+	}
+
+	// Takes the last move back, returns it (null when there is none)
+	const Entry* Undo(BoardType& board) {
+		if (top <= 0) return nullptr;
+		const Entry& entry = entries[--top];
+		ToggleMove(board.Pieces(entry.player), board.Pieces(OpponentOf(entry.player)), Bits(1) << entry.square, entry.flips);
+		return &entry;
+	}
+
+	// Plays the last undone move again, returns it (null when there is none)
+	const Entry* Redo(BoardType& board) {
+		if (top >= end) return nullptr;
+		const Entry& entry = entries[top++];
+		ToggleMove(board.Pieces(entry.player), board.Pieces(OpponentOf(entry.player)), Bits(1) << entry.square, entry.flips);
+		return &entry;
+	}
+
+private:
+	Entry entries[Capacity];
+	int top = 0;
+	int end = 0;            // Above top: undone moves that can be redone
+};
+
+// Square names in the usual notation: column letter a-h, row number 1-8 ("f5")
+int ParseSquare(const char* text);      // Returns -1 for an invalid name
+std::string SquareName(int square);
+
+// Plays a move list such as "f5d6c3" from the given position, passing automatically.
+// Returns false at the first illegal move or a trailing half move. Appends the played squares to played if given.
+bool PlayMoveSequence(Board& board, char& player, const char* moves, std::vector<uint8_t>* played = nullptr);
@@ -0,0 +1,164 @@
+#include "BoardLayer.h"
+#include "Main.h"
+#include "Profiler.h"
+#include "TextCache.h"
+#include <algorithm>
+#include <iostream>
+
+SDL_Texture* BoardLayer::boardTexture = nullptr;
+SDL_Texture* BoardLayer::pieceTexture = nullptr;
+int BoardLayer::pieceSize = 0;
+
+void BoardLayer::Rebuild(SDL_Renderer* renderer) {
+	Shutdown();
+	if (!renderer || !SDL_RenderTargetSupported(renderer)) return;
+
+	SDL_Texture* previousTarget = SDL_GetRenderTarget(renderer);
+
+	boardTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, WINDOW_WIDTH, WINDOW_HEIGHT);
+	Profiler::CountTextureCreated();
+	if (boardTexture) {
+		SDL_SetRenderTarget(renderer, boardTexture);
+		DrawDirect(renderer);
+	}
+	else {
+		std::cerr << "Failed to create board layer: " << SDL_GetError() << std::endl;
+	}
+
+	pieceSize = CELL_SIZE - PIECE_MARGIN;
+	pieceTexture = CreateScaledPieces(renderer, pieceSize);
+
+	SDL_SetRenderTarget(renderer, previousTarget);
+}
+
+void BoardLayer::Shutdown() {
+	if (boardTexture) SDL_DestroyTexture(boardTexture);
+	if (pieceTexture) SDL_DestroyTexture(pieceTexture);
+	boardTexture = nullptr;
+	pieceTexture = nullptr;
+}
+
+void BoardLayer::Draw(SDL_Renderer* renderer) {
+	if (boardTexture) {
+		SDL_RenderCopy(renderer, boardTexture, NULL, NULL);
+		Profiler::CountDrawCall();
+	}
+	else {
+		DrawDirect(renderer);
+	}
+}
+
+SDL_Texture* BoardLayer::GetPiece(char piece, SDL_Rect& source) {
+	if (pieceTexture) {
+		source = { (piece == 'B') ? 0 : pieceSize, 0, pieceSize, pieceSize };
+		return pieceTexture;
+	}
+	source = (piece == 'B') ? blackPieceRect : whitePieceRect;
+	return pieceSpriteSheet;
+}
+
+void BoardLayer::DrawDirect(SDL_Renderer* renderer) {
+	// Green background
+	SDL_SetRenderDrawColor(renderer, GAME_BACKGROUND_COLOR);
+	SDL_RenderClear(renderer);
+	Profiler::CountDrawCall();
+
+	// Draw Grid (dark green lines)
+	SDL_SetRenderDrawColor(renderer, GRID_COLOR);
+	for (int i = 0; i <= GRID_SIZE; i++) {
+		// Vertical lines
+		SDL_RenderDrawLine(
+			renderer,
+			GRID_OFFSET_X + i * CELL_SIZE,
+			GRID_OFFSET_Y,
+			GRID_OFFSET_X + i * CELL_SIZE,
+			GRID_OFFSET_Y + GRID_HEIGHT
+		);
+
+		// Horizontal lines
+		SDL_RenderDrawLine(
+			renderer,
+			GRID_OFFSET_X,
+			GRID_OFFSET_Y + i * CELL_SIZE,
+			GRID_OFFSET_X + GRID_WIDTH,
+			GRID_OFFSET_Y + i * CELL_SIZE
+		);
+		Profiler::CountDrawCall(2);
+	}
+
+	// Coordinates inside the edge cells (letters along the bottom row, numbers down the left column),
+	// the text around the board leaves no room outside it
+	int labelSize = std::max(CELL_SIZE / 5, 8);
+	int padding = std::max(CELL_SIZE / 20, 1);
+	char label[3] = { 0, 0, 0 };
+	for (int i = 0; i < GRID_SIZE; i++) {
+		label[0] = static_cast<char>('a' + i);
+		label[1] = 0;
+		TextCache::Text letter = TextCache::Get(renderer, label, labelSize, { GRID_COLOR });
+		if (letter.texture) {
+			SDL_Rect rect = {
+				GRID_OFFSET_X + (i + 1) * CELL_SIZE - letter.width - padding,
+				GRID_OFFSET_Y + GRID_HEIGHT - letter.height,
+				letter.width,
+				letter.height
+			};
+			SDL_RenderCopy(renderer, letter.texture, NULL, &rect);
+			Profiler::CountDrawCall();
+		}
+
+		// Row 10 of the large board takes two digits
+		label[0] = static_cast<char>((i < 9) ? '1' + i : '0' + (i + 1) / 10);
+		label[1] = (i < 9) ? 0 : static_cast<char>('0' + (i + 1) % 10);
+		TextCache::Text number = TextCache::Get(renderer, label, labelSize, { GRID_COLOR });
+		if (number.texture) {
+			SDL_Rect rect = { GRID_OFFSET_X + padding + 1, GRID_OFFSET_Y + i * CELL_SIZE, number.width, number.height };
+			SDL_RenderCopy(renderer, number.texture, NULL, &rect);
+			Profiler::CountDrawCall();
+		}
+	}
+}
+
+SDL_Texture* BoardLayer::CreateScaledPieces(SDL_Renderer* renderer, int size) {
+	if (!pieceSpriteSheet || size <= 0) return nullptr;
+
+	// Both discs side by side, as in the sprite sheet
+	SDL_Texture* current = pieceSpriteSheet;
+	int currentSize = blackPieceRect.w;
+	SDL_Rect source = { blackPieceRect.x, blackPieceRect.y, 2 * currentSize, currentSize };
+	SDL_SetTextureBlendMode(pieceSpriteSheet, SDL_BLENDMODE_NONE);
+
+	// Halving steps with bilinear filtering average every source pixel (like mipmaps),
+	// a single large downscale would skip most of them
+	while (current) {
+		int nextSize = (currentSize / 2 >= size) ? currentSize / 2 : size;
+		SDL_Texture* next = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 2 * nextSize, nextSize);
+		Profiler::CountTextureCreated();
+		if (next) {
+			SDL_SetTextureBlendMode(next, SDL_BLENDMODE_NONE);
+			SDL_SetTextureScaleMode(current, SDL_ScaleModeLinear);
+			SDL_SetRenderTarget(renderer, next);
+			SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+			SDL_RenderClear(renderer);
+
+			SDL_Rect destination = { 0, 0, 2 * nextSize, nextSize };
+			SDL_RenderCopy(renderer, current, &source, &destination);
+			Profiler::CountDrawCall(2);
+			source = destination;
+		}
+		else {
+			std::cerr << "Failed to create piece sprites: " << SDL_GetError() << std::endl;
+		}
+
+		if (current != pieceSpriteSheet) SDL_DestroyTexture(current);
+		current = next;
+		currentSize = nextSize;
+		if (currentSize == size) break;
+	}
+
+	SDL_SetTextureBlendMode(pieceSpriteSheet, SDL_BLENDMODE_BLEND);
+	if (current) {
+		SDL_SetTextureBlendMode(current, SDL_BLENDMODE_BLEND);
+		SDL_SetTextureScaleMode(current, SDL_ScaleModeLinear);
+	}
+	return current;
+}
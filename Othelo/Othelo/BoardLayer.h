@@ -0,0 +1,25 @@
+#pragma once
+#include <SDL.h>
+
+// Cached board layer: background, grid and coordinate labels are drawn once into a
+// render target, and the disc sprites are pre-scaled to the cell size.
+// Both are rebuilt only when the window size changes.
+class BoardLayer {
+public:
+	static void Rebuild(SDL_Renderer* renderer);
+	static void Shutdown();
+
+	// Draws the whole static board (one copy when render targets are supported)
+	static void Draw(SDL_Renderer* renderer);
+
+	// Disc sprite for 'B' or 'W' at the current disc size, falls back to the sprite sheet
+	static SDL_Texture* GetPiece(char piece, SDL_Rect& source);
+
+private:
+	static void DrawDirect(SDL_Renderer* renderer);
+	static SDL_Texture* CreateScaledPieces(SDL_Renderer* renderer, int size);
+
+	static SDL_Texture* boardTexture;
+	static SDL_Texture* pieceTexture;
+	static int pieceSize;
+};
@@ -0,0 +1,75 @@
+#include "Book.h"
+#include <algorithm>
+#include <fstream>
+
+static bool EntryLess(const BookEntry& a, const BookEntry& b) {
+	if (a.player != b.player) return a.player < b.player;
+	return a.opponent < b.opponent;
+}
+
+bool OpeningBook::Open(const char* path) {
+	Close();
+	if (!file.Open(path)) return false;
+
+	// Reject anything that does not look like a complete book of this version
+	const BookHeader* header = reinterpret_cast<const BookHeader*>(file.Data());
+	if (file.Size() < sizeof(BookHeader)
+		|| header->magic != BOOK_MAGIC
+		|| header->version != BOOK_VERSION
+		|| file.Size() != sizeof(BookHeader) + size_t(header->entryCount) * sizeof(BookEntry)) {
+		file.Close();
+		return false;
+	}
+
+	entries = reinterpret_cast<const BookEntry*>(file.Data() + sizeof(BookHeader));
+	entryCount = header->entryCount;
+	return true;
+}
+
+void OpeningBook::Close() {
+	file.Close();
+	entries = nullptr;
+	entryCount = 0;
+}
+
+int OpeningBook::GetMoves(Bitboard player, Bitboard opponent, BookMove* moves, int maxMoves) const {
+	if (!entries) return 0;
+
+	Bitboard canonicalPlayer, canonicalOpponent;
+	int symmetry = CanonicalPosition(player, opponent, canonicalPlayer, canonicalOpponent);
+
+	BookEntry key = {};
+	key.player = canonicalPlayer;
+	key.opponent = canonicalOpponent;
+	const BookEntry* first = std::lower_bound(entries, entries + entryCount, key, EntryLess);
+
+	// Book squares are canonical: find the legal move that maps onto each of them
+	Bitboard legal = GetMovesMask(player, opponent);
+	int count = 0;
+	for (const BookEntry* entry = first; entry < entries + entryCount && count < maxMoves; entry++) {
+		if (entry->player != canonicalPlayer || entry->opponent != canonicalOpponent) break;
+
+		Bitboard candidates = legal;
+		while (candidates) {
+			int square = PopLowestBit(candidates);
+			if (TransformSquare(square, symmetry) == entry->move) {
+				moves[count++] = { square, entry->score, entry->weight };
+				break;
+			}
+		}
+	}
+
+	return count;
+}
+
+bool OpeningBook::Write(const char* path, std::vector<BookEntry> entries) {
+	std::stable_sort(entries.begin(), entries.end(), EntryLess);
+
+	std::ofstream out(path, std::ios::binary);
+	if (!out) return false;
+
+	BookHeader header = { BOOK_MAGIC, BOOK_VERSION, static_cast<uint32_t>(entries.size()), 0 };
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(BookEntry));
+	return static_cast<bool>(out);
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+#include "MappedFile.h"
+
+// Opening book file: a header followed by entries sorted by (player, opponent), one entry per book move.
+// Positions are stored in canonical orientation (see CanonicalPosition), little-endian.
+#define BOOK_MAGIC          0x4B4F4F42      // "BOOK"
+#define BOOK_VERSION        1
+#define BOOK_MAX_MOVES      32
+
+struct BookHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entryCount;
+	uint32_t reserved;
+};
+
+struct BookEntry {
+	uint64_t player;        // Side to move
+	uint64_t opponent;
+	int16_t score;          // Search score of the move in evaluator units, from the mover's point of view
+	uint16_t weight;        // Relative chance of playing the move
+	uint8_t move;           // Square in the canonical orientation
+	uint8_t padding[3];
+};
+
+static_assert(sizeof(BookHeader) == 16, "BookHeader must match the file layout");
+static_assert(sizeof(BookEntry) == 24, "BookEntry must match the file layout");
+
+// A book move in the orientation of the queried position
+struct BookMove {
+	int square;
+	int score;
+	int weight;
+};
+
+class OpeningBook {
+public:
+	// Maps the file, the entries are read in place
+	bool Open(const char* path);
+	void Close();
+	bool IsOpen() const { return entries != nullptr; }
+	uint32_t GetEntryCount() const { return entryCount; }
+
+	// Book moves for the side to move, returns how many were written
+	int GetMoves(Bitboard player, Bitboard opponent, BookMove* moves, int maxMoves) const;
+
+	// Sorts the entries and writes a book file
+	static bool Write(const char* path, std::vector<BookEntry> entries);
+
+private:
+	MappedFile file;
+	const BookEntry* entries = nullptr;
+	uint32_t entryCount = 0;
+};
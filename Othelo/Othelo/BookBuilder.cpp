@@ -0,0 +1,101 @@
+#include "BookBuilder.h"
+#include "AI.h"
+#include "Book.h"
+#include <iostream>
+#include <set>
+
+struct BookBuilder {
+	AI ai;
+	int plies;
+	std::set<std::pair<Bitboard, Bitboard>> visited;
+	std::vector<BookEntry> entries;
+
+	// Score for the side to move, following passes to the end of the game
+	int ScorePosition(Bitboard player, Bitboard opponent) {
+		if (GetMovesMask(player, opponent)) {
+			Board board;
+			board.black = player;
+			board.white = opponent;
+			ai.MakeMove(board, BLACK_PIECE);
+			return ai.GetLastScore();
+		}
+		if (GetMovesMask(opponent, player)) return -ScorePosition(opponent, player);
+
+		int diff = PopCount(player) - PopCount(opponent);
+		if (diff > 0) return SCORE_WIN + diff;
+		if (diff < 0) return -SCORE_WIN + diff;
+		return 0;
+	}
+
+	void Expand(Bitboard player, Bitboard opponent, int ply) {
+		if (ply >= plies) return;
+
+		Bitboard moves = GetMovesMask(player, opponent);
+		if (!moves) {
+			if (GetMovesMask(opponent, player)) Expand(opponent, player, ply);
+			return;
+		}
+
+		// Symmetric copies of a position are expanded once
+		Bitboard canonicalPlayer, canonicalOpponent;
+		int symmetry = CanonicalPosition(player, opponent, canonicalPlayer, canonicalOpponent);
+		if (!visited.insert({ canonicalPlayer, canonicalOpponent }).second) return;
+
+		int squares[BOARD_CELLS];
+		int scores[BOARD_CELLS];
+		int count = 0;
+		int best = -SCORE_INFINITY;
+		while (moves) {
+			int square = PopLowestBit(moves);
+			Bitboard flips = GetFlipsMask(square, player, opponent);
+			int score = -ScorePosition(opponent & ~flips, player | flips | (1ULL << square));
+			squares[count] = square;
+			scores[count++] = score;
+			best = std::max(best, score);
+		}
+
+		// The margin is in discs, the scores in evaluator units
+		const int margin = BOOK_BUILD_MARGIN * PATTERN_SCORE_PER_DISC;
+		for (int i = 0; i < count; i++) {
+			int loss = best - scores[i];
+			if (loss > margin) continue;
+
+			BookEntry entry = {};
+			entry.player = canonicalPlayer;
+			entry.opponent = canonicalOpponent;
+			entry.score = static_cast<int16_t>(scores[i]);
+			entry.weight = static_cast<uint16_t>(margin + 1 - loss);
+			entry.move = static_cast<uint8_t>(TransformSquare(squares[i], symmetry));
+			entries.push_back(entry);
+		}
+
+		if (visited.size() % 100 == 0) {
+			std::cout << visited.size() << " positions, " << entries.size() << " moves\n";
+		}
+
+		for (int i = 0; i < count; i++) {
+			if (best - scores[i] > margin) continue;
+
+			Bitboard flips = GetFlipsMask(squares[i], player, opponent);
+			Expand(opponent & ~flips, player | flips | (1ULL << squares[i]), ply + 1);
+		}
+	}
+};
+
+int BuildOpeningBook(const char* path, int plies, int depth) {
+	BookBuilder builder;
+	builder.plies = plies;
+	builder.ai.SetLimits({ depth, 0, 0, 0, 0, false, false });
+
+	Board board;
+	board.Reset();
+	builder.Expand(board.black, board.white, 0);
+
+	if (!OpeningBook::Write(path, builder.entries)) {
+		std::cerr << "Cannot write " << path << "\n";
+		return 1;
+	}
+
+	std::cout << "Wrote " << builder.entries.size() << " moves in " << builder.visited.size() << " positions to " << path << "\n";
+	return 0;
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+// Opening book generation (console output only, no SDL)
+
+#define BOOK_BUILD_PLIES        12      // Book depth in moves from the start position
+#define BOOK_BUILD_DEPTH        8       // Search depth used to score each move
+#define BOOK_BUILD_MARGIN       2       // Moves scoring within this many discs of the best one are kept
+
+// Expands every kept move from the start position to the given number of plies, scoring each
+// legal move with a fixed-depth search, and writes the result as a book file.
+int BuildOpeningBook(const char* path, int plies, int depth);
@@ -10,7 +10,7 @@ static std::string cheatBuffer;
 static bool ctrlHeld = false;
 
 void HandleCheatCodes(SDL_Event& event, GameState currentState,
-	std::vector<std::vector<char>>& board,
+	VariantGame& board,
 	char& currentPlayer, bool& gameOver)
 {
 	if (currentState != GameState::GAME_SCREEN || gameOver) return;
@@ -31,16 +31,14 @@ void HandleCheatCodes(SDL_Event& event, GameState currentState,
 				std::cout << "Cheat activated: Instant Win\n";
 				for (int i = 0; i < GRID_SIZE; ++i) {
 					for (int j = 0; j < GRID_SIZE; ++j) {
-						board[i][j] = currentPlayer;
+						board.SetPiece(i, j, currentPlayer);
 					}
 				}	
 				cheatBuffer.clear();
 			}
 			else if (cheatBuffer == CHEAT_CODE_CLEAR) {
 				std::cout << "Cheat activated: Board Clear\n";
-				for (auto& row : board)
-					for (char& cell : row)
-						cell = ' ';
+				board.Clear();
 				currentPlayer = 'X';
 				cheatBuffer.clear();
 			}
@@ -61,8 +59,8 @@ void HandleCheatCodes(SDL_Event& event, GameState currentState,
 					int row = (mouseY - GRID_OFFSET_Y) / CELL_SIZE;
 					int col = (mouseX - GRID_OFFSET_X) / CELL_SIZE;
 
-					if (board[row][col] != ' ') {
-						board[row][col] = currentPlayer;
+					if (board.GetPiece(row, col) != ' ') {
+						board.SetPiece(row, col, currentPlayer);
 						std::cout << "Swapped mark at (" << row << "," << col << ")\n";
 					}
 				}
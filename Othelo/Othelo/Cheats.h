@@ -2,6 +2,7 @@
 #include <vector>
 #include <SDL.h>
 #include "Title.h"
+#include "VariantGame.h"
 
 #define CHEAT_CODE_WIN          "win"
 #define CHEAT_CODE_CLEAR        "clear"
@@ -10,5 +11,5 @@
 #define CHEAT_BUFFER_LENGHT     10
 
 void HandleCheatCodes(SDL_Event& event, GameState currentState,
-	std::vector<std::vector<char>>& board,
+	VariantGame& board,
 	char& currentPlayer, bool& gameOver);
\ No newline at end of file
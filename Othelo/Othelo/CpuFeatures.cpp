@@ -0,0 +1,57 @@
+#include "CpuFeatures.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+static CpuFeatures DetectCpuFeatures() {
+	CpuFeatures features;
+#if defined(CPU_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	features.sse41 = ((info[2] >> 19) & 1) != 0;
+
+	// AVX needs the CPU flag and the OS saving the YMM state (OSXSAVE, then XCR0 bits 1 and 2)
+	bool osAvx = ((info[2] >> 27) & 1) && ((info[2] >> 28) & 1) && (_xgetbv(0) & 6) == 6;
+	if (maxLeaf >= 7) {
+		__cpuidex(info, 7, 0);
+		features.avx2 = osAvx && ((info[1] >> 5) & 1);
+	}
+#elif defined(CPU_X86) && defined(__GNUC__)
+	__builtin_cpu_init();
+	features.sse41 = __builtin_cpu_supports("sse4.1") != 0;
+	features.avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+	return features;
+}
+
+const CpuFeatures& GetCpuFeatures() {
+	static const CpuFeatures features = DetectCpuFeatures();
+	return features;
+}
+
+bool IsSimdKernelSupported(SimdKernel kernel) {
+#ifdef CPU_X86
+	if (kernel == SimdKernel::AVX2) return GetCpuFeatures().avx2;
+	if (kernel == SimdKernel::SSE41) return GetCpuFeatures().sse41;
+	return true;
+#else
+	return kernel == SimdKernel::SCALAR;
+#endif
+}
+
+SimdKernel GetBestSimdKernel() {
+	if (IsSimdKernelSupported(SimdKernel::AVX2)) return SimdKernel::AVX2;
+	if (IsSimdKernelSupported(SimdKernel::SSE41)) return SimdKernel::SSE41;
+	return SimdKernel::SCALAR;
+}
+
+const char* GetSimdKernelName(SimdKernel kernel) {
+	switch (kernel) {
+	case SimdKernel::AVX2: return "AVX2";
+	case SimdKernel::SSE41: return "SSE4.1";
+	default: return "scalar";
+	}
+}
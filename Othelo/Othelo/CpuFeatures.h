@@ -0,0 +1,35 @@
+#pragma once
+
+// Instruction set extensions of the running CPU, for kernels chosen at runtime.
+// SIMD kernels are compiled for their own target (TARGET_SSE41, TARGET_AVX2) while the rest
+// of the program keeps the baseline instruction set, so the same binary runs on any x86-64 CPU.
+// 32-bit builds lack the 64-bit lane moves, they use the portable code.
+#if defined(_M_X64) || defined(__x86_64__)
+#define CPU_X86
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TARGET_SSE41
+#define TARGET_AVX2
+#else
+#define TARGET_SSE41    __attribute__((target("sse4.1")))
+#define TARGET_AVX2     __attribute__((target("avx2")))
+#endif
+
+struct CpuFeatures {
+	bool sse41 = false;     // Also implies SSSE3
+	bool avx2 = false;      // Only set when the OS saves the YMM registers
+};
+
+const CpuFeatures& GetCpuFeatures();
+
+// Kernel variants of the SIMD code paths, from the portable one up
+enum class SimdKernel {
+	SCALAR,
+	SSE41,
+	AVX2
+};
+
+bool IsSimdKernelSupported(SimdKernel kernel);
+SimdKernel GetBestSimdKernel();
+const char* GetSimdKernelName(SimdKernel kernel);
@@ -0,0 +1,580 @@
+#include "Endgame.h"
+#include <algorithm>
+#include <memory>
+
+#define ENDGAME_SCORE_MAX   64
+#define ENDGAME_ETC_MIN_EMPTIES 12
+#define ENDGAME_STABILITY_MIN_ALPHA     8   // Below this the opponent would need too many stable discs
+
+// Board quadrants, used for parity ordering
+static const Bitboard QUADRANT_MASKS[4] = {
+	0x000000000F0F0F0FULL,
+	0x00000000F0F0F0F0ULL,
+	0x0F0F0F0F00000000ULL,
+	0xF0F0F0F000000000ULL
+};
+
+static const Bitboard CORNER_MASK = 0x8100000000000081ULL;
+
+// Squares around each square: a move needs at least one opponent disc there
+static Bitboard neighbourMasks[BOARD_CELLS];
+
+static bool InitNeighbourMasks() {
+	for (int square = 0; square < BOARD_CELLS; square++) {
+		int row = square / BOARD_SIZE;
+		int col = square % BOARD_SIZE;
+		Bitboard mask = 0;
+		for (int dr = -1; dr <= 1; dr++) {
+			for (int dc = -1; dc <= 1; dc++) {
+				int r = row + dr;
+				int c = col + dc;
+				if ((dr || dc) && r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE) {
+					mask |= SquareMask(r, c);
+				}
+			}
+		}
+		neighbourMasks[square] = mask;
+	}
+	return true;
+}
+
+static const bool neighbourMasksReady = InitNeighbourMasks();
+
+// Occupied squares whose line is occupied all the way to the board edge in one direction.
+// The runs start at the edge squares (no neighbour at square - SHIFT) and grow by occluded fill.
+template <int SHIFT>
+static inline Bitboard FillToEdgeUp(Bitboard occupied, Bitboard hasNeighbour) {
+	Bitboard run = occupied & ~hasNeighbour;
+	Bitboard path = occupied & hasNeighbour;
+	run |= path & (run << SHIFT);
+	path &= path << SHIFT;
+	run |= path & (run << (2 * SHIFT));
+	path &= path << (2 * SHIFT);
+	return run | (path & (run << (4 * SHIFT)));
+}
+
+// Same towards square + SHIFT
+template <int SHIFT>
+static inline Bitboard FillToEdgeDown(Bitboard occupied, Bitboard hasNeighbour) {
+	Bitboard run = occupied & ~hasNeighbour;
+	Bitboard path = occupied & hasNeighbour;
+	run |= path & (run >> SHIFT);
+	path &= path >> SHIFT;
+	run |= path & (run >> (2 * SHIFT));
+	path &= path >> (2 * SHIFT);
+	return run | (path & (run >> (4 * SHIFT)));
+}
+
+// Exactly stable discs of one edge, by the 8 own and 8 opponent bits of the line. An edge disc can
+// only be flipped along its edge, so a disc is stable when no sequence of moves on the line flips it
+// (any empty square may be played by either side, through the other directions).
+static uint8_t edgeStable[256][256];
+
+static uint8_t FlipLine(uint8_t own, uint8_t other, int square) {
+	uint8_t flips = 0;
+	for (int step : { -1, 1 }) {
+		uint8_t run = 0;
+		int i = square + step;
+		while (i >= 0 && i < BOARD_SIZE && ((other >> i) & 1)) {
+			run |= 1 << i;
+			i += step;
+		}
+		if (i >= 0 && i < BOARD_SIZE && ((own >> i) & 1)) flips |= run;
+	}
+	return flips;
+}
+
+static uint8_t ComputeEdgeStable(uint8_t own, uint8_t other, bool* known) {
+	if (known[own * 256 + other]) return edgeStable[own][other];
+
+	uint8_t stable = own;
+	uint8_t empty = static_cast<uint8_t>(~(own | other));
+	for (int square = 0; square < BOARD_SIZE && stable; square++) {
+		if (!((empty >> square) & 1)) continue;
+		uint8_t bit = static_cast<uint8_t>(1 << square);
+
+		// Own move: our discs stay ours, those flipped back later are not stable
+		uint8_t flips = FlipLine(own, other, square);
+		stable &= ComputeEdgeStable(own | bit | flips, other & ~flips, known);
+
+		// Opponent move
+		flips = FlipLine(other, own, square);
+		stable &= ComputeEdgeStable(own & ~flips, other | bit | flips, known) & ~flips;
+	}
+
+	known[own * 256 + other] = true;
+	edgeStable[own][other] = stable;
+	return stable;
+}
+
+// The 8 squares of the a and h columns as line bits (row order) and back
+static uint8_t PackColumnA(Bitboard b) {
+	return static_cast<uint8_t>(((b & 0x0101010101010101ULL) * 0x0102040810204080ULL) >> 56);
+}
+
+static Bitboard columnAUnpack[256];
+
+static bool InitEdgeStable() {
+	std::unique_ptr<bool[]> known(new bool[256 * 256]());
+	for (int own = 0; own < 256; own++) {
+		for (int other = 0; other < 256; other++) {
+			if (!(own & other)) ComputeEdgeStable(static_cast<uint8_t>(own), static_cast<uint8_t>(other), known.get());
+		}
+	}
+	for (int line = 0; line < 256; line++) {
+		Bitboard column = 0;
+		for (int row = 0; row < BOARD_SIZE; row++) {
+			if (PackColumnA(1ULL << (row * BOARD_SIZE)) & line) column |= 1ULL << (row * BOARD_SIZE);
+		}
+		columnAUnpack[line] = column;
+	}
+	return true;
+}
+
+static const bool edgeStableReady = InitEdgeStable();
+
+// The exactly stable discs of the 4 edges. Stability grows from the corners, without one there are none.
+static inline Bitboard GetEdgeStableDiscs(Bitboard own, Bitboard occupied) {
+	if (!(own & CORNER_MASK)) return 0;
+
+	Bitboard other = occupied & ~own;
+	Bitboard stable = edgeStable[own & 0xFF][other & 0xFF];
+	stable |= static_cast<Bitboard>(edgeStable[own >> 56][other >> 56]) << 56;
+	stable |= columnAUnpack[edgeStable[PackColumnA(own)][PackColumnA(other)]];
+	stable |= columnAUnpack[edgeStable[PackColumnA(own >> 7)][PackColumnA(other >> 7)]] << 7;
+	return stable;
+}
+
+// Lower bound on the discs that can never be flipped: the exactly stable edge discs, then growing
+// inwards, on each of the 4 lines through a stable disc the line is full or one neighbour is the
+// board edge or another stable disc
+static Bitboard GetStableDiscs(Bitboard own, Bitboard occupied) {
+	Bitboard stable = GetEdgeStableDiscs(own, occupied);
+	if (!stable) return 0;
+
+	// Full lines: occupied up to the edge both ways
+	Bitboard fullRows = FillToEdgeUp<1>(occupied, 0xFEFEFEFEFEFEFEFEULL) & FillToEdgeDown<1>(occupied, 0x7F7F7F7F7F7F7F7FULL);
+	Bitboard fullColumns = FillToEdgeUp<8>(occupied, 0xFFFFFFFFFFFFFF00ULL) & FillToEdgeDown<8>(occupied, 0x00FFFFFFFFFFFFFFULL);
+	Bitboard fullDiagonals = FillToEdgeUp<9>(occupied, 0xFEFEFEFEFEFEFE00ULL) & FillToEdgeDown<9>(occupied, 0x007F7F7F7F7F7F7FULL);
+	Bitboard fullAntiDiagonals = FillToEdgeUp<7>(occupied, 0x7F7F7F7F7F7F7F00ULL) & FillToEdgeDown<7>(occupied, 0x00FEFEFEFEFEFEFEULL);
+
+	const Bitboard edgeColumns = 0x8181818181818181ULL;
+	const Bitboard edgeRows = 0xFF000000000000FFULL;
+	const Bitboard edges = edgeColumns | edgeRows;
+
+	for (;;) {
+		Bitboard horizontal = fullRows | edgeColumns | ((stable << 1) & 0xFEFEFEFEFEFEFEFEULL) | ((stable >> 1) & 0x7F7F7F7F7F7F7F7FULL);
+		Bitboard vertical = fullColumns | edgeRows | (stable << 8) | (stable >> 8);
+		Bitboard diagonal = fullDiagonals | edges | ((stable << 9) & 0xFEFEFEFEFEFEFEFEULL) | ((stable >> 9) & 0x7F7F7F7F7F7F7F7FULL);
+		Bitboard antiDiagonal = fullAntiDiagonals | edges | ((stable << 7) & 0x7F7F7F7F7F7F7F7FULL) | ((stable >> 7) & 0xFEFEFEFEFEFEFEFEULL);
+
+		Bitboard grown = stable | (own & horizontal & vertical & diagonal & antiDiagonal);
+		if (grown == stable) return stable;
+		stable = grown;
+	}
+}
+
+// Quadrants with an odd number of empties: moving there first tends to leave the opponent the last move elsewhere
+static inline Bitboard OddRegions(Bitboard empty) {
+	Bitboard odd = 0;
+	for (Bitboard quadrant : QUADRANT_MASKS) {
+		if (PopCount(empty & quadrant) & 1) odd |= quadrant;
+	}
+	return odd;
+}
+
+// Final disc difference, empty squares go to the winner
+static inline int FinalScore(Bitboard player, Bitboard opponent) {
+	int own = PopCount(player);
+	int other = PopCount(opponent);
+	int empties = BOARD_CELLS - own - other;
+	int diff = own - other;
+	if (diff > 0) return diff + empties;
+	if (diff < 0) return diff - empties;
+	return 0;
+}
+
+EndgameSolver::EndgameSolver() {
+	table.reset(new EndgameEntry[size_t(1) << ENDGAME_TT_SIZE_BITS]);
+	ClearTable();
+}
+
+void EndgameSolver::ClearTable() {
+	size_t size = size_t(1) << ENDGAME_TT_SIZE_BITS;
+	for (size_t i = 0; i < size; i++) {
+		table[i] = { 0, -ENDGAME_SCORE_MAX, ENDGAME_SCORE_MAX, -1 };
+	}
+}
+
+void EndgameSolver::CheckStop() {
+	if (shouldStop && shouldStop()) stopped = true;
+}
+
+bool EndgameSolver::SolveRoot(Bitboard player, Bitboard opponent, bool winLossOnly, int& bestMove, int& score) {
+	nodes = 0;
+	stopped = false;
+	rootMove = -1;
+
+	if (!GetMovesMask(player, opponent)) return false;
+
+	if (winLossOnly) {
+		return SearchRoot(player, opponent, -1, 1, bestMove, score);
+	}
+
+	// MTD(f): null-window probes converge on the exact score and reuse each other's table bounds.
+	// Final scores are always even, so the probes step by two discs.
+	int lower = -ENDGAME_SCORE_MAX;
+	int upper = ENDGAME_SCORE_MAX;
+	int guess = 0;
+	bestMove = -1;
+
+	while (lower < upper) {
+		int beta = (guess == lower) ? guess + 1 : guess;
+		int move = -1;
+		if (!SearchRoot(player, opponent, beta - 1, beta, move, guess)) return false;
+
+		if (guess < beta) {
+			upper = guess;
+		}
+		else {
+			lower = guess;
+			bestMove = move;
+		}
+	}
+
+	// Every move loses by the maximum: any legal move will do
+	if (bestMove < 0) bestMove = LowestBitIndex(GetMovesMask(player, opponent));
+
+	score = lower;
+	return true;
+}
+
+bool EndgameSolver::SearchRoot(Bitboard player, Bitboard opponent, int alpha, int beta, int& bestMove, int& score) {
+	int moveList[BOARD_CELLS];
+	int moveCount = OrderMoves(player, opponent, GetMovesMask(player, opponent), rootMove, moveList);
+	int bestScore = -ENDGAME_SCORE_MAX - 1;
+
+	for (int i = 0; i < moveCount; i++) {
+		int move = moveList[i];
+		Bitboard flips = GetFlipsMask(move, player, opponent);
+		Bitboard newPlayer = player | flips | (1ULL << move);
+		Bitboard newOpponent = opponent & ~flips;
+
+		int value;
+		if (i == 0) {
+			value = -Solve(newOpponent, newPlayer, -beta, -alpha, false);
+		}
+		else {
+			value = -Solve(newOpponent, newPlayer, -alpha - 1, -alpha, false);
+			if (value > alpha && value < beta && !stopped) {
+				value = -Solve(newOpponent, newPlayer, -beta, -alpha, false);
+			}
+		}
+
+		if (stopped) return false;
+
+		if (value > bestScore) {
+			bestScore = value;
+			bestMove = move;
+		}
+		if (value > alpha) alpha = value;
+		if (alpha >= beta) break;
+	}
+
+	// The refuting move is tried first by the next probe
+	rootMove = bestMove;
+	score = bestScore;
+	return true;
+}
+
+int EndgameSolver::Solve(Bitboard player, Bitboard opponent, int alpha, int beta, bool passed) {
+	int empties = BOARD_CELLS - PopCount(player | opponent);
+	if (empties < ENDGAME_FASTEST_FIRST) {
+		return SolveParity(player, opponent, alpha, beta, passed);
+	}
+
+	if ((++nodes & 4095) == 0) CheckStop();
+	if (stopped) return 0;
+
+	Bitboard moves = GetMovesMask(player, opponent);
+	if (!moves) {
+		if (passed) return FinalScore(player, opponent);
+		return -Solve(opponent, player, -beta, -alpha, true);
+	}
+
+	// Stability cutoff: the opponent's stable discs cap the best score we can reach
+	if (alpha >= ENDGAME_STABILITY_MIN_ALPHA) {
+		int maxScore = BOARD_CELLS - 2 * PopCount(GetStableDiscs(opponent, player | opponent));
+		if (maxScore <= alpha) return maxScore;
+	}
+
+	// Exact bounds from the table
+	EndgameEntry* entry = nullptr;
+	uint64_t key = 0;
+	int ttMove = -1;
+	if (empties >= ENDGAME_TT_MIN_EMPTIES) {
+		key = HashPosition(player, opponent);
+		entry = &table[key & ((size_t(1) << ENDGAME_TT_SIZE_BITS) - 1)];
+		if (entry->key == key) {
+			if (entry->lower >= beta) return entry->lower;
+			if (entry->upper <= alpha) return entry->upper;
+			if (entry->lower == entry->upper) return entry->lower;
+			alpha = std::max(alpha, static_cast<int>(entry->lower));
+			beta = std::min(beta, static_cast<int>(entry->upper));
+			ttMove = entry->bestMove;
+		}
+	}
+
+	int moveList[BOARD_CELLS];
+	int moveCount = OrderMoves(player, opponent, moves, ttMove, moveList);
+
+	// Enhanced transposition cutoff: a child already known to be bad enough for the opponent refutes this node
+	if (empties > ENDGAME_ETC_MIN_EMPTIES) {
+		for (int i = 0; i < moveCount; i++) {
+			Bitboard flips = GetFlipsMask(moveList[i], player, opponent);
+			uint64_t childKey = HashPosition(opponent & ~flips, player | flips | (1ULL << moveList[i]));
+			const EndgameEntry& child = table[childKey & ((size_t(1) << ENDGAME_TT_SIZE_BITS) - 1)];
+			if (child.key == childKey && -child.upper >= beta) return -child.upper;
+		}
+	}
+
+	int originalAlpha = alpha;
+	int bestScore = -ENDGAME_SCORE_MAX - 1;
+	int bestMove = -1;
+
+	for (int i = 0; i < moveCount; i++) {
+		int move = moveList[i];
+		Bitboard flips = GetFlipsMask(move, player, opponent);
+		Bitboard newPlayer = player | flips | (1ULL << move);
+		Bitboard newOpponent = opponent & ~flips;
+
+		int value;
+		if (i == 0) {
+			value = -Solve(newOpponent, newPlayer, -beta, -alpha, false);
+		}
+		else {
+			value = -Solve(newOpponent, newPlayer, -alpha - 1, -alpha, false);
+			if (value > alpha && value < beta && !stopped) {
+				value = -Solve(newOpponent, newPlayer, -beta, -alpha, false);
+			}
+		}
+
+		if (stopped) return 0;
+
+		if (value > bestScore) {
+			bestScore = value;
+			bestMove = move;
+		}
+		if (value > alpha) alpha = value;
+		if (alpha >= beta) break;
+	}
+
+	if (entry) {
+		if (entry->key != key) {
+			*entry = { key, -ENDGAME_SCORE_MAX, ENDGAME_SCORE_MAX, -1 };
+		}
+		if (bestScore <= originalAlpha) entry->upper = static_cast<int8_t>(bestScore);
+		else if (bestScore >= beta) entry->lower = static_cast<int8_t>(bestScore);
+		else entry->lower = entry->upper = static_cast<int8_t>(bestScore);
+		entry->bestMove = static_cast<int8_t>(bestMove);
+	}
+
+	return bestScore;
+}
+
+int EndgameSolver::SolveParity(Bitboard player, Bitboard opponent, int alpha, int beta, bool passed) {
+	Bitboard empty = ~(player | opponent);
+	Bitboard odd = OddRegions(empty);
+
+	// Odd quadrants first, for both the move loop and the last-empties list
+	Bitboard ordered[2] = { empty & odd, empty & ~odd };
+
+	if (PopCount(empty) <= ENDGAME_LAST_EMPTIES) {
+		int squares[ENDGAME_LAST_EMPTIES];
+		int count = 0;
+		for (Bitboard group : ordered) {
+			while (group) squares[count++] = PopLowestBit(group);
+		}
+		switch (count) {
+		case 4: return SolveLast4(player, opponent, alpha, beta, squares[0], squares[1], squares[2], squares[3], passed);
+		case 3: return SolveLast3(player, opponent, alpha, beta, squares[0], squares[1], squares[2], passed);
+		case 2: return SolveLast2(player, opponent, alpha, beta, squares[0], squares[1], passed);
+		case 1: return SolveLast1(player, opponent, squares[0]);
+		default: return FinalScore(player, opponent);
+		}
+	}
+
+	nodes++;
+
+	// Stability cutoff, as in Solve
+	if (alpha >= ENDGAME_STABILITY_MIN_ALPHA) {
+		int maxScore = BOARD_CELLS - 2 * PopCount(GetStableDiscs(opponent, player | opponent));
+		if (maxScore <= alpha) return maxScore;
+	}
+
+	int bestScore = -ENDGAME_SCORE_MAX - 1;
+	bool moved = false;
+
+	// Few empties left: trying each empty square is cheaper than generating the move mask
+	for (Bitboard group : ordered) {
+		while (group) {
+			int square = PopLowestBit(group);
+			if (!(neighbourMasks[square] & opponent)) continue;
+			Bitboard flips = GetFlipsMask(square, player, opponent);
+			if (!flips) continue;
+
+			moved = true;
+			int value = -SolveParity(opponent & ~flips, player | flips | (1ULL << square), -beta, -alpha, false);
+			if (value > bestScore) {
+				bestScore = value;
+				if (value > alpha) alpha = value;
+				if (alpha >= beta) return bestScore;
+			}
+		}
+	}
+
+	if (!moved) {
+		if (passed) return FinalScore(player, opponent);
+		return -SolveParity(opponent, player, -beta, -alpha, true);
+	}
+
+	return bestScore;
+}
+
+int EndgameSolver::SolveLast4(Bitboard player, Bitboard opponent, int alpha, int beta, int sq1, int sq2, int sq3, int sq4, bool passed) {
+	nodes++;
+	int bestScore = -ENDGAME_SCORE_MAX - 1;
+
+	// Each move leaves the other three in their parity order
+	const int squares[4] = { sq1, sq2, sq3, sq4 };
+	for (int i = 0; i < 4; i++) {
+		int square = squares[i];
+		if (!(neighbourMasks[square] & opponent)) continue;
+		Bitboard flips = GetFlipsMask(square, player, opponent);
+		if (!flips) continue;
+
+		int a = squares[i == 0 ? 1 : 0];
+		int b = squares[i <= 1 ? 2 : 1];
+		int c = squares[i <= 2 ? 3 : 2];
+		int value = -SolveLast3(opponent & ~flips, player | flips | (1ULL << square), -beta, -alpha, a, b, c, false);
+		if (value > bestScore) {
+			bestScore = value;
+			if (value > alpha) alpha = value;
+			if (alpha >= beta) return bestScore;
+		}
+	}
+
+	if (bestScore > -ENDGAME_SCORE_MAX - 1) return bestScore;
+	if (passed) return FinalScore(player, opponent);
+	return -SolveLast4(opponent, player, -beta, -alpha, sq1, sq2, sq3, sq4, true);
+}
+
+int EndgameSolver::SolveLast3(Bitboard player, Bitboard opponent, int alpha, int beta, int sq1, int sq2, int sq3, bool passed) {
+	nodes++;
+	int bestScore = -ENDGAME_SCORE_MAX - 1;
+
+	const int squares[3] = { sq1, sq2, sq3 };
+	for (int i = 0; i < 3; i++) {
+		int square = squares[i];
+		if (!(neighbourMasks[square] & opponent)) continue;
+		Bitboard flips = GetFlipsMask(square, player, opponent);
+		if (!flips) continue;
+
+		int a = squares[i == 0 ? 1 : 0];
+		int b = squares[i <= 1 ? 2 : 1];
+		int value = -SolveLast2(opponent & ~flips, player | flips | (1ULL << square), -beta, -alpha, a, b, false);
+		if (value > bestScore) {
+			bestScore = value;
+			if (value > alpha) alpha = value;
+			if (alpha >= beta) return bestScore;
+		}
+	}
+
+	if (bestScore > -ENDGAME_SCORE_MAX - 1) return bestScore;
+	if (passed) return FinalScore(player, opponent);
+	return -SolveLast3(opponent, player, -beta, -alpha, sq1, sq2, sq3, true);
+}
+
+int EndgameSolver::SolveLast2(Bitboard player, Bitboard opponent, int alpha, int beta, int sq1, int sq2, bool passed) {
+	nodes++;
+	int bestScore = -ENDGAME_SCORE_MAX - 1;
+
+	if (neighbourMasks[sq1] & opponent) {
+		Bitboard flips = GetFlipsMask(sq1, player, opponent);
+		if (flips) {
+			bestScore = -SolveLast1(opponent & ~flips, player | flips | (1ULL << sq1), sq2);
+			if (bestScore >= beta) return bestScore;
+		}
+	}
+
+	if (neighbourMasks[sq2] & opponent) {
+		Bitboard flips = GetFlipsMask(sq2, player, opponent);
+		if (flips) {
+			int value = -SolveLast1(opponent & ~flips, player | flips | (1ULL << sq2), sq1);
+			if (value > bestScore) bestScore = value;
+		}
+	}
+
+	if (bestScore > -ENDGAME_SCORE_MAX - 1) return bestScore;
+	if (passed) return FinalScore(player, opponent);
+	return -SolveLast2(opponent, player, -beta, -alpha, sq1, sq2, true);
+}
+
+int EndgameSolver::SolveLast1(Bitboard player, Bitboard opponent, int square) {
+	nodes++;
+	int own = PopCount(player);
+
+	// Board becomes full after one move, so the score follows from our disc count
+	Bitboard flips = GetFlipsMask(square, player, opponent);
+	if (flips) {
+		own += PopCount(flips) + 1;
+		return 2 * own - BOARD_CELLS;
+	}
+
+	flips = GetFlipsMask(square, opponent, player);
+	if (flips) {
+		own -= PopCount(flips);
+		return 2 * own - BOARD_CELLS;
+	}
+
+	// Nobody can take the last square: it goes to the winner
+	int diff = 2 * own - (BOARD_CELLS - 1);
+	return (diff > 0) ? diff + 1 : diff - 1;
+}
+
+int EndgameSolver::OrderMoves(Bitboard player, Bitboard opponent, Bitboard moves, int ttMove, int* moveList) const {
+	int scores[BOARD_CELLS];
+	int count = 0;
+
+	while (moves) {
+		int move = PopLowestBit(moves);
+		int score;
+		if (move == ttMove) {
+			score = 1 << 30;
+		}
+		else {
+			// Fastest first: leave the opponent as few replies as possible, no corners, and keep stable discs.
+			// The edge discs are most of the stable ones this early and cost a few lookups.
+			Bitboard flips = GetFlipsMask(move, player, opponent);
+			Bitboard newPlayer = player | flips | (1ULL << move);
+			Bitboard newOpponent = opponent & ~flips;
+			Bitboard replies = GetMovesMask(newOpponent, newPlayer);
+			Bitboard empty = ~(newPlayer | newOpponent);
+			Bitboard around = ((newPlayer << 1) & 0xFEFEFEFEFEFEFEFEULL) | ((newPlayer >> 1) & 0x7F7F7F7F7F7F7F7FULL);
+			around |= (around << 8) | (around >> 8) | (newPlayer << 8) | (newPlayer >> 8);
+			score = -16 * PopCount(replies) - 32 * PopCount(replies & CORNER_MASK) - 4 * PopCount(around & empty)
+				+ 8 * PopCount(GetEdgeStableDiscs(newPlayer, newPlayer | newOpponent));
+		}
+
+		int i = count++;
+		while (i > 0 && scores[i - 1] < score) {
+			scores[i] = scores[i - 1];
+			moveList[i] = moveList[i - 1];
+			i--;
+		}
+		scores[i] = score;
+		moveList[i] = move;
+	}
+
+	return count;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include "Board.h"
+
+#define ENDGAME_TT_SIZE_BITS        18      // 2^18 entries (4 MB)
+#define ENDGAME_TT_MIN_EMPTIES      7      // Shallower nodes are cheaper to search than to look up
+#define ENDGAME_FASTEST_FIRST       6       // Fastest-first ordering from here up, parity ordering below
+#define ENDGAME_LAST_EMPTIES        4       // Specialized routines without move generation
+
+// Endgame table entry (exact bounds on the final disc difference)
+struct EndgameEntry {
+	uint64_t key;
+	int8_t lower;
+	int8_t upper;
+	int8_t bestMove;
+};
+
+// Exact endgame solver: full-width search on the final disc difference
+// (empty squares go to the winner, as in tournament scoring)
+class EndgameSolver {
+public:
+	EndgameSolver();
+
+	// Solves the position for the side to move. winLossOnly searches the (-1, 1) window,
+	// so the score only tells win (> 0), draw (0) or loss (< 0).
+	// Returns false if the stop callback interrupted the search.
+	bool SolveRoot(Bitboard player, Bitboard opponent, bool winLossOnly, int& bestMove, int& score);
+
+	// Polled every few thousand nodes, returning true aborts the search
+	void SetStopCallback(std::function<bool()> callback) { shouldStop = callback; }
+
+	uint64_t GetNodeCount() const { return nodes; }
+	void ClearTable();
+
+private:
+	std::unique_ptr<EndgameEntry[]> table;
+	std::function<bool()> shouldStop;
+	uint64_t nodes = 0;
+	bool stopped = false;
+	int rootMove = -1;
+
+	bool SearchRoot(Bitboard player, Bitboard opponent, int alpha, int beta, int& bestMove, int& score);
+	int Solve(Bitboard player, Bitboard opponent, int alpha, int beta, bool passed);
+	int SolveParity(Bitboard player, Bitboard opponent, int alpha, int beta, bool passed);
+	int SolveLast4(Bitboard player, Bitboard opponent, int alpha, int beta, int sq1, int sq2, int sq3, int sq4, bool passed);
+	int SolveLast3(Bitboard player, Bitboard opponent, int alpha, int beta, int sq1, int sq2, int sq3, bool passed);
+	int SolveLast2(Bitboard player, Bitboard opponent, int alpha, int beta, int sq1, int sq2, bool passed);
+	int SolveLast1(Bitboard player, Bitboard opponent, int square);
+	int OrderMoves(Bitboard player, Bitboard opponent, Bitboard moves, int ttMove, int* moveList) const;
+	void CheckStop();
+};
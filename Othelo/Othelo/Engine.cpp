@@ -0,0 +1,270 @@
+#include "Engine.h"
+#include "AI.h"
+#include <cctype>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+
+static const char* LEVEL_NAMES[] = { "easy", "medium", "hard", "expert" };
+
+class EngineSession {
+public:
+	explicit EngineSession(std::ostream& out);
+	~EngineSession() { StopSearch(); }
+
+	// Returns false once the session should end
+	bool Execute(const std::string& line);
+
+private:
+	std::ostream& output;
+	std::mutex outputMutex;         // The search thread prints info lines while commands are read
+	AI ai;
+	AIDifficulty level = AIDifficulty::HARD;
+	bool useBook = false;
+	std::string searchType = "level";
+	Board board;
+	char player = BLACK_PIECE;
+	std::thread searchThread;
+
+	void Print(const std::string& line);
+	void StopSearch();
+	void SetPosition(std::istringstream& arguments);
+	void Go(std::istringstream& arguments);
+	void Display();
+	void PrintInfo(const SearchInfo& info);
+};
+
+EngineSession::EngineSession(std::ostream& out) : output(out), ai(AIDifficulty::HARD) {
+	board.Reset();
+	ai.LoadBook(AI_BOOK_FILE);
+	ai.LoadWeights(AI_WEIGHTS_FILE);
+	ai.LoadNetwork(AI_NETWORK_FILE);
+	ai.SetInfoCallback([this](const SearchInfo& info) { PrintInfo(info); });
+}
+
+void EngineSession::Print(const std::string& line) {
+	std::lock_guard<std::mutex> lock(outputMutex);
+	output << line << std::endl;
+}
+
+void EngineSession::StopSearch() {
+	if (searchThread.joinable()) {
+		ai.Stop();
+		searchThread.join();
+	}
+}
+
+void EngineSession::PrintInfo(const SearchInfo& info) {
+	std::string line = "info depth " + std::to_string(info.depth);
+	if (info.score > SCORE_EVAL_LIMIT || info.score < -SCORE_EVAL_LIMIT) {
+		int discs = (info.score > 0) ? info.score - SCORE_WIN : info.score + SCORE_WIN;
+		line += " score discs " + std::to_string(discs);
+	}
+	else {
+		line += " score eval " + std::to_string(info.score);
+	}
+
+	uint64_t nps = info.nodes * 1000 / static_cast<uint64_t>(std::max(info.elapsedMs, 1));
+	line += " nodes " + std::to_string(info.nodes) + " nps " + std::to_string(nps) + " time " + std::to_string(info.elapsedMs) + " pv";
+	for (int move : info.principalVariation) {
+		line += ' ';
+		line += (move < 0) ? std::string("pass") : SquareName(move);
+	}
+	Print(line);
+}
+
+void EngineSession::SetPosition(std::istringstream& arguments) {
+	std::string kind;
+	arguments >> kind;
+
+	Board position;
+	char side = BLACK_PIECE;
+	if (kind == "start") {
+		position.Reset();
+	}
+	else if (kind == "board") {
+		std::string cells, sideName;
+		arguments >> cells >> sideName;
+		if (cells.size() != BOARD_CELLS || sideName.size() != 1) {
+			Print("error position board needs 64 cells and the side to move");
+			return;
+		}
+
+		position.Clear();
+		for (int square = 0; square < BOARD_CELLS; square++) {
+			char cell = cells[square];
+			if (cell == 'X' || cell == 'x' || cell == 'B' || cell == 'b' || cell == '*') position.black |= 1ULL << square;
+			else if (cell == 'O' || cell == 'o' || cell == 'W' || cell == 'w') position.white |= 1ULL << square;
+			else if (cell != '-' && cell != '.') {
+				Print("error invalid cell '" + std::string(1, cell) + "'");
+				return;
+			}
+		}
+
+		char sideCell = static_cast<char>(toupper(sideName[0]));
+		if (sideCell == 'X' || sideCell == 'B') side = BLACK_PIECE;
+		else if (sideCell == 'O' || sideCell == 'W') side = WHITE_PIECE;
+		else {
+			Print("error invalid side to move");
+			return;
+		}
+	}
+	else {
+		Print("error position needs start or board");
+		return;
+	}
+
+	std::string token;
+	if (arguments >> token) {
+		if (token != "moves") {
+			Print("error unexpected '" + token + "'");
+			return;
+		}
+		std::string moves, part;
+		while (arguments >> part) moves += part;
+		if (!PlayMoveSequence(position, side, moves.c_str())) {
+			Print("error illegal move list");
+			return;
+		}
+	}
+
+	board = position;
+	player = side;
+}
+
+void EngineSession::Go(std::istringstream& arguments) {
+	StopSearch();
+
+	// Explicit limits replace the level budget, the endgame settings stay
+	AILevelSettings limits = AI_LEVEL_SETTINGS[static_cast<int>(level)];
+	limits.useBook = useBook;
+	if (searchType != "level") limits.useMcts = (searchType == "mcts");
+
+	std::string token;
+	bool customLimits = false;
+	AILevelSettings custom = limits;
+	custom.maxDepth = AI_LEVEL_SETTINGS[static_cast<int>(AIDifficulty::EXPERT)].maxDepth;
+	custom.timeLimitMs = 0;
+	custom.nodeLimit = 0;
+	while (arguments >> token) {
+		if (token == "infinite") {
+			customLimits = true;
+			continue;
+		}
+
+		long long value = 0;
+		if (!(arguments >> value) || value < 0) {
+			Print("error missing value for " + token);
+			return;
+		}
+		if (token == "depth") custom.maxDepth = static_cast<int>(std::min<long long>(value, custom.maxDepth));
+		else if (token == "movetime") custom.timeLimitMs = static_cast<int>(value);
+		else if (token == "nodes") custom.nodeLimit = static_cast<uint64_t>(value);
+		else {
+			Print("error unknown go option " + token);
+			return;
+		}
+		customLimits = true;
+	}
+	ai.SetLimits(customLimits ? custom : limits);
+
+	// The stop flag is cleared here, before this thread reads the next command
+	std::future<std::pair<int, int>> result = ai.StartSearch(board, player);
+	searchThread = std::thread([this](std::future<std::pair<int, int>> move) {
+		std::pair<int, int> best = move.get();
+		Print("bestmove " + ((best.first < 0) ? std::string("pass") : SquareName(best.first * BOARD_SIZE + best.second)));
+	}, std::move(result));
+}
+
+void EngineSession::Display() {
+	std::string text = "  a b c d e f g h\n";
+	for (int row = 0; row < BOARD_SIZE; row++) {
+		text += static_cast<char>('1' + row);
+		for (int col = 0; col < BOARD_SIZE; col++) {
+			char piece = board.GetPiece(row, col);
+			text += ' ';
+			text += (piece == BLACK_PIECE) ? 'X' : (piece == WHITE_PIECE) ? 'O' : '-';
+		}
+		text += '\n';
+	}
+	text += std::string((player == BLACK_PIECE) ? "X" : "O") + " to move, X " + std::to_string(board.CountPieces(BLACK_PIECE))
+		+ " O " + std::to_string(board.CountPieces(WHITE_PIECE));
+	Print(text);
+}
+
+bool EngineSession::Execute(const std::string& line) {
+	std::istringstream arguments(line);
+	std::string command;
+	if (!(arguments >> command)) return true;
+
+	if (command == "quit") {
+		return false;
+	}
+	if (command == "stop") {
+		StopSearch();
+	}
+	else if (command == "isready") {
+		Print("readyok");
+	}
+	else if (command == "go") {
+		Go(arguments);
+	}
+	else if (command == "display") {
+		Display();
+	}
+	else {
+		// Everything else changes the engine state, so a running search ends first
+		StopSearch();
+		if (command == "newgame") {
+			ai.ClearTables();
+			board.Reset();
+			player = BLACK_PIECE;
+		}
+		else if (command == "position") {
+			SetPosition(arguments);
+		}
+		else if (command == "level") {
+			std::string name;
+			arguments >> name;
+			int index = 0;
+			while (index < static_cast<int>(AIDifficulty::DIFFICULTY_COUNT) && name != LEVEL_NAMES[index]) index++;
+			if (index == static_cast<int>(AIDifficulty::DIFFICULTY_COUNT)) {
+				Print("error unknown level " + name);
+			}
+			else {
+				level = static_cast<AIDifficulty>(index);
+			}
+		}
+		else if (command == "threads") {
+			int count = 0;
+			arguments >> count;
+			ai.SetThreadCount(std::max(1, std::min(count, AI_MAX_THREADS)));
+		}
+		else if (command == "search") {
+			std::string type;
+			arguments >> type;
+			if (type == "level" || type == "alphabeta" || type == "mcts") searchType = type;
+			else Print("error unknown search " + type);
+		}
+		else if (command == "book") {
+			std::string state;
+			arguments >> state;
+			useBook = (state == "on");
+		}
+		else {
+			Print("error unknown command " + command);
+		}
+	}
+	return true;
+}
+
+int RunEngineProtocol(std::istream& input, std::ostream& output) {
+	EngineSession session(output);
+	std::string line;
+	while (std::getline(input, line)) {
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		if (!session.Execute(line)) break;
+	}
+	return 0;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <iostream>
+
+// Line-based engine protocol on stdin/stdout (console only, no SDL), for scripts, analysis
+// tools and matches against other engines. Commands, one per line:
+//
+//   isready                                 -> readyok
+//   newgame                                 Clears the search tables
+//   position start [moves f5d6...]          Standard start, then a move list (passes are implicit)
+//   position board <64 cells> <side> [moves f5d6...]
+//                                           Cells row by row from a1: X/B/* black, O/W white, -/. empty.
+//                                           Side is X/B or O/W
+//   level easy|medium|hard|expert           Budget and endgame settings used by go (default hard)
+//   search level|alphabeta|mcts             Search of the level (default), or force one (mcts counts nodes as playouts)
+//   threads <n>
+//   book on|off                             Opening book moves (off by default, for analysis)
+//   go [depth <n>] [movetime <ms>] [nodes <n>] [infinite]
+//                                           Searches in the background, limits override the level
+//   stop                                    Ends the search, bestmove follows
+//   display                                 Prints the board
+//   quit
+//
+// While searching the engine prints, after every completed iteration:
+//   info depth <d> score <eval|discs> <n> nodes <n> nps <n> time <ms> pv <moves>
+// and at the end:
+//   bestmove <square>|pass
+// "score discs" is a proven final disc difference, "score eval" a heuristic value.
+int RunEngineProtocol(std::istream& input, std::ostream& output);
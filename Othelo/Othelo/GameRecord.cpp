@@ -0,0 +1,246 @@
+#include "GameRecord.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+// Plays one recorded move, the side to move passes first if it has none
+static bool ApplyMove(Board& board, char& player, int square) {
+	if (square < 0 || square >= BOARD_CELLS) return false;
+	if (!board.GetValidMoves(player)) player = OpponentOf(player);
+	if (!board.MakeMove(square / BOARD_SIZE, square % BOARD_SIZE, player)) return false;
+	player = OpponentOf(player);
+	return true;
+}
+
+// A side without moves passes, unless the game is over
+static void ApplyPass(const Board& board, char& player) {
+	if (!board.GetValidMoves(player) && board.GetValidMoves(OpponentOf(player))) {
+		player = OpponentOf(player);
+	}
+}
+
+void GameRecord::Reset(const Board& board, char player) {
+	start = board;
+	startPlayer = player;
+	moves.clear();
+}
+
+bool GameRecord::IsStandardStart() const {
+	Board standard;
+	standard.Reset();
+	return start.black == standard.black && start.white == standard.white && startPlayer == BLACK_PIECE;
+}
+
+bool GameRecord::PlayTo(int ply, Board& board, char& player) const {
+	board = start;
+	player = startPlayer;
+	int count = std::min(ply, static_cast<int>(moves.size()));
+	for (int i = 0; i < count; i++) {
+		if (!ApplyMove(board, player, moves[i])) return false;
+	}
+	ApplyPass(board, player);
+	return true;
+}
+
+RecordResult GameRecord::GetResult(int& blackDiscs, int& whiteDiscs) const {
+	Board board;
+	char player;
+	PlayTo(static_cast<int>(moves.size()), board, player);
+	blackDiscs = board.CountPieces(BLACK_PIECE);
+	whiteDiscs = board.CountPieces(WHITE_PIECE);
+
+	if (board.GetValidMoves(BLACK_PIECE) || board.GetValidMoves(WHITE_PIECE)) return RecordResult::IN_PROGRESS;
+	if (blackDiscs > whiteDiscs) return RecordResult::BLACK_WINS;
+	if (whiteDiscs > blackDiscs) return RecordResult::WHITE_WINS;
+	return RecordResult::DRAW;
+}
+
+bool GameRecord::Save(const char* path) const {
+	if (moves.size() > RECORD_MAX_MOVES) return false;
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	int blackDiscs, whiteDiscs;
+	RecordResult result = GetResult(blackDiscs, whiteDiscs);
+
+	RecordHeader header = {};
+	header.magic = RECORD_MAGIC;
+	header.version = RECORD_VERSION;
+	header.moveCount = static_cast<uint8_t>(moves.size());
+	header.result = static_cast<uint8_t>(result);
+	header.blackPlayer = static_cast<uint8_t>(blackPlayer);
+	header.whitePlayer = static_cast<uint8_t>(whitePlayer);
+	header.blackLevel = blackLevel;
+	header.whiteLevel = whiteLevel;
+	header.blackDiscs = static_cast<uint8_t>(blackDiscs);
+	header.whiteDiscs = static_cast<uint8_t>(whiteDiscs);
+	header.startPlayer = static_cast<uint8_t>(startPlayer);
+	header.startBlack = start.black;
+	header.startWhite = start.white;
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(moves.data()), moves.size());
+	return static_cast<bool>(file);
+}
+
+bool GameRecord::Load(const char* path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	RecordHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+	if (header.magic != RECORD_MAGIC || header.version != RECORD_VERSION) return false;
+	if (header.moveCount > RECORD_MAX_MOVES) return false;
+	if (header.startPlayer != BLACK_PIECE && header.startPlayer != WHITE_PIECE) return false;
+	if (header.startBlack & header.startWhite) return false;
+
+	GameRecord loaded;
+	loaded.start.black = header.startBlack;
+	loaded.start.white = header.startWhite;
+	loaded.startPlayer = static_cast<char>(header.startPlayer);
+	loaded.blackPlayer = static_cast<RecordPlayer>(header.blackPlayer);
+	loaded.whitePlayer = static_cast<RecordPlayer>(header.whitePlayer);
+	loaded.blackLevel = header.blackLevel;
+	loaded.whiteLevel = header.whiteLevel;
+	loaded.moves.resize(header.moveCount);
+	if (!file.read(reinterpret_cast<char*>(loaded.moves.data()), loaded.moves.size())) return false;
+
+	Board board;
+	char player;
+	if (!loaded.PlayTo(header.moveCount, board, player)) return false;
+
+	*this = loaded;
+	return true;
+}
+
+std::string GameRecord::ToTranscript() const {
+	std::string transcript;
+	transcript.reserve(moves.size() * 2);
+	for (uint8_t move : moves) {
+		transcript += SquareName(move);
+	}
+	return transcript;
+}
+
+bool GameRecord::FromTranscript(const char* text) {
+	GameRecord parsed;
+	parsed.start.Reset();
+	parsed.startPlayer = BLACK_PIECE;
+	parsed.blackPlayer = blackPlayer;
+	parsed.whitePlayer = whitePlayer;
+	parsed.blackLevel = blackLevel;
+	parsed.whiteLevel = whiteLevel;
+
+	Board board = parsed.start;
+	char player = parsed.startPlayer;
+	if (!PlayMoveSequence(board, player, text, &parsed.moves)) return false;
+
+	*this = parsed;
+	return true;
+}
+
+int ExportTranscripts(const char* outputPath, const char* const* recordPaths, int recordCount) {
+	std::ofstream output(outputPath);
+	if (!output) {
+		std::cerr << "Cannot write " << outputPath << "\n";
+		return 1;
+	}
+
+	int exported = 0;
+	for (int i = 0; i < recordCount; i++) {
+		GameRecord record;
+		if (!record.Load(recordPaths[i])) {
+			std::cerr << "Skipping " << recordPaths[i] << ": not a valid game record\n";
+			continue;
+		}
+		if (!record.IsStandardStart()) {
+			std::cerr << "Skipping " << recordPaths[i] << ": does not start from the standard position\n";
+			continue;
+		}
+		output << record.ToTranscript() << "\n";
+		exported++;
+	}
+
+	std::cout << "Exported " << exported << " of " << recordCount << " games to " << outputPath << "\n";
+	return (exported == recordCount) ? 0 : 1;
+}
+
+int ImportTranscripts(const char* inputPath, const char* outputPrefix) {
+	std::ifstream input(inputPath);
+	if (!input) {
+		std::cerr << "Cannot read " << inputPath << "\n";
+		return 1;
+	}
+
+	int lineNumber = 0;
+	int imported = 0;
+	int failed = 0;
+	std::string line;
+	while (std::getline(input, line)) {
+		lineNumber++;
+		line.erase(std::remove_if(line.begin(), line.end(), [](char c) { return c == ' ' || c == '\t' || c == '\r'; }), line.end());
+		if (line.empty() || line[0] == '#') continue;
+
+		GameRecord record;
+		if (!record.FromTranscript(line.c_str())) {
+			std::cerr << inputPath << ":" << lineNumber << ": illegal move sequence\n";
+			failed++;
+			continue;
+		}
+
+		char path[512];
+		snprintf(path, sizeof(path), "%s%05d.orec", outputPrefix, imported + 1);
+		if (!record.Save(path)) {
+			std::cerr << "Cannot write " << path << "\n";
+			return 1;
+		}
+		imported++;
+	}
+
+	std::cout << "Imported " << imported << " games (" << failed << " rejected)\n";
+	return (failed == 0) ? 0 : 1;
+}
+
+bool GameReplay::Load(const GameRecord& source) {
+	record = source;
+	snapshots.clear();
+	snapshots.reserve(record.moves.size() / RECORD_SNAPSHOT_PLIES + 1);
+
+	// One full pass keeps the position every RECORD_SNAPSHOT_PLIES plies (before the implicit pass)
+	board = record.start;
+	player = record.startPlayer;
+	for (size_t i = 0; i <= record.moves.size(); i++) {
+		if (i % RECORD_SNAPSHOT_PLIES == 0) {
+			snapshots.push_back({ board.black, board.white, player });
+		}
+		if (i < record.moves.size() && !ApplyMove(board, player, record.moves[i])) {
+			snapshots.clear();
+			record.moves.clear();
+			Seek(0);
+			return false;
+		}
+	}
+
+	Seek(0);
+	return true;
+}
+
+void GameReplay::Seek(int targetPly) {
+	ply = std::max(0, std::min(targetPly, GetLength()));
+	if (snapshots.empty()) {
+		board = record.start;
+		player = record.startPlayer;
+		return;
+	}
+
+	const Snapshot& snapshot = snapshots[ply / RECORD_SNAPSHOT_PLIES];
+	board.black = snapshot.black;
+	board.white = snapshot.white;
+	player = snapshot.player;
+	for (int i = ply / RECORD_SNAPSHOT_PLIES * RECORD_SNAPSHOT_PLIES; i < ply; i++) {
+		ApplyMove(board, player, record.moves[i]);
+	}
+	ApplyPass(board, player);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Board.h"
+
+// Game record file: a 32-byte header followed by one byte per move (the square index).
+// Passes are not stored, a side without moves passes implicitly as in PlayMoveSequence.
+// The start position is part of the header, so games edited with cheats still replay. Little-endian.
+#define RECORD_MAGIC            0x4345524F      // "OREC"
+#define RECORD_VERSION          1
+#define RECORD_MAX_MOVES        BOARD_CELLS
+#define RECORD_SNAPSHOT_PLIES   8               // Plies between the positions kept by GameReplay
+
+enum class RecordPlayer : uint8_t {
+	HUMAN,
+	AI
+};
+
+enum class RecordResult : uint8_t {
+	IN_PROGRESS,
+	BLACK_WINS,
+	WHITE_WINS,
+	DRAW
+};
+
+struct RecordHeader {
+	uint32_t magic;
+	uint16_t version;
+	uint8_t moveCount;
+	uint8_t result;         // RecordResult of the final position
+	uint8_t blackPlayer;    // RecordPlayer
+	uint8_t whitePlayer;
+	uint8_t blackLevel;     // AIDifficulty, only meaningful for AI players
+	uint8_t whiteLevel;
+	uint8_t blackDiscs;     // Disc count of the final position
+	uint8_t whiteDiscs;
+	uint8_t startPlayer;    // BLACK_PIECE or WHITE_PIECE
+	uint8_t reserved;
+	uint64_t startBlack;
+	uint64_t startWhite;
+};
+
+static_assert(sizeof(RecordHeader) == 32, "RecordHeader must match the file layout");
+
+struct GameRecord {
+	Board start;
+	char startPlayer = BLACK_PIECE;
+	RecordPlayer blackPlayer = RecordPlayer::HUMAN;
+	RecordPlayer whitePlayer = RecordPlayer::HUMAN;
+	uint8_t blackLevel = 0;
+	uint8_t whiteLevel = 0;
+	std::vector<uint8_t> moves;
+
+	// Starts an empty record from the given position, players and levels are kept
+	void Reset(const Board& board, char player);
+	void AddMove(int square) { moves.push_back(static_cast<uint8_t>(square)); }
+	bool IsStandardStart() const;
+
+	// Position after the first ply moves, the side to move already passed if it has no move.
+	// Returns false if a recorded move is illegal.
+	bool PlayTo(int ply, Board& board, char& player) const;
+
+	// Result and disc counts of the position after the last move
+	RecordResult GetResult(int& blackDiscs, int& whiteDiscs) const;
+
+	// Load rejects files whose moves are not legal from the stored start position
+	bool Save(const char* path) const;
+	bool Load(const char* path);
+
+	// Transcript notation from the standard start position ("f5d6c3...")
+	std::string ToTranscript() const;
+	bool FromTranscript(const char* text);
+};
+
+// Bulk conversion for the command line tools, both return the process exit code.
+// Transcript files hold one game per line, blank lines and lines starting with '#' are skipped.
+int ExportTranscripts(const char* outputPath, const char* const* recordPaths, int recordCount);
+int ImportTranscripts(const char* inputPath, const char* outputPrefix);
+
+// Random access over a record. Every RECORD_SNAPSHOT_PLIES plies the position is kept,
+// so a seek replays at most RECORD_SNAPSHOT_PLIES - 1 moves from the closest snapshot.
+class GameReplay {
+public:
+	bool Load(const GameRecord& source);
+
+	int GetLength() const { return static_cast<int>(record.moves.size()); }
+	int GetPly() const { return ply; }
+	void Seek(int targetPly);
+
+	const GameRecord& GetRecord() const { return record; }
+	const Board& GetBoard() const { return board; }
+	char GetPlayer() const { return player; }
+	int GetLastMove() const { return (ply > 0) ? record.moves[ply - 1] : -1; }
+
+private:
+	struct Snapshot {
+		Bitboard black;
+		Bitboard white;
+		char player;
+	};
+
+	GameRecord record;
+	std::vector<Snapshot> snapshots;
+	Board board;
+	char player = BLACK_PIECE;
+	int ply = 0;
+};
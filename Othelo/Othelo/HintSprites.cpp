@@ -0,0 +1,128 @@
+#include "HintSprites.h"
+#include "Main.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#define HINT_CAPACITY   (VARIANT_MAX_SIZE * VARIANT_MAX_SIZE)
+
+SDL_Texture* HintSprites::texture = nullptr;
+int HintSprites::spriteSize = 0;
+std::vector<SDL_Vertex> HintSprites::vertices(HINT_CAPACITY * 4);
+std::vector<int> HintSprites::indices;
+int HintSprites::count = 0;
+
+// Share of the pixel (x, y) inside the circle, estimated on a grid of subsamples
+static float CircleCoverage(int x, int y, float center, float radius) {
+	int inside = 0;
+	for (int sy = 0; sy < HINT_SUPERSAMPLING; sy++) {
+		for (int sx = 0; sx < HINT_SUPERSAMPLING; sx++) {
+			float dx = x + (sx + 0.5f) / HINT_SUPERSAMPLING - center;
+			float dy = y + (sy + 0.5f) / HINT_SUPERSAMPLING - center;
+			if (dx * dx + dy * dy <= radius * radius) inside++;
+		}
+	}
+	return static_cast<float>(inside) / (HINT_SUPERSAMPLING * HINT_SUPERSAMPLING);
+}
+
+void HintSprites::Rebuild(SDL_Renderer* renderer) {
+	Shutdown();
+
+	// Markers take up to half a cell, side by side in the order of HintKind
+	spriteSize = std::max(CELL_SIZE / 2, 8);
+	int kinds = static_cast<int>(HintKind::HINT_KIND_COUNT);
+	SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormat(0, spriteSize * kinds, spriteSize, 32, SDL_PIXELFORMAT_RGBA32);
+	if (!surface) {
+		std::cerr << "Failed to create hint sprites: " << SDL_GetError() << std::endl;
+		return;
+	}
+
+	float center = spriteSize / 2.0f;
+	float dotRadius = spriteSize * 0.25f;
+	float ringOuter = spriteSize * 0.3f;
+	float ringInner = ringOuter - std::max(1.5f, spriteSize * 0.08f);
+	float evalOuter = spriteSize * 0.4f;
+	float evalInner = evalOuter - std::max(1.5f, spriteSize * 0.06f);
+
+	SDL_LockSurface(surface);
+	for (int y = 0; y < spriteSize; y++) {
+		Uint32* row = reinterpret_cast<Uint32*>(static_cast<Uint8*>(surface->pixels) + y * surface->pitch);
+		for (int x = 0; x < spriteSize; x++) {
+			float dot = CircleCoverage(x, y, center, dotRadius);
+			float ring = CircleCoverage(x, y, center, ringOuter) - CircleCoverage(x, y, center, ringInner);
+			float evalOuterCoverage = CircleCoverage(x, y, center, evalOuter);
+			float evalInnerCoverage = CircleCoverage(x, y, center, evalInner);
+
+			// The evaluation marker is white inside a dark border, vertex colors only tint the white part
+			Uint8 border = 40;
+			Uint8 evalLevel = evalOuterCoverage > 0.0f ?
+				static_cast<Uint8>(border + (255 - border) * evalInnerCoverage / evalOuterCoverage) : 255;
+
+			row[x] = SDL_MapRGBA(surface->format, 255, 255, 255, static_cast<Uint8>(std::lround(dot * 255)));
+			row[spriteSize + x] = SDL_MapRGBA(surface->format, 255, 255, 255, static_cast<Uint8>(std::lround(ring * 255)));
+			row[2 * spriteSize + x] = SDL_MapRGBA(surface->format, evalLevel, evalLevel, evalLevel,
+				static_cast<Uint8>(std::lround(evalOuterCoverage * 255)));
+		}
+	}
+	SDL_UnlockSurface(surface);
+
+	texture = SDL_CreateTextureFromSurface(renderer, surface);
+	Profiler::CountTextureCreated();
+	SDL_FreeSurface(surface);
+	if (!texture) {
+		std::cerr << "Failed to create hint texture: " << SDL_GetError() << std::endl;
+		return;
+	}
+	SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+}
+
+void HintSprites::Shutdown() {
+	if (texture) SDL_DestroyTexture(texture);
+	texture = nullptr;
+}
+
+void HintSprites::Begin() {
+	count = 0;
+}
+
+void HintSprites::Add(int row, int col, HintKind kind, SDL_Color color) {
+	if (count == HINT_CAPACITY) return;
+
+	float centerX = GRID_OFFSET_X + col * CELL_SIZE + CELL_SIZE / 2.0f;
+	float centerY = GRID_OFFSET_Y + row * CELL_SIZE + CELL_SIZE / 2.0f;
+	float half = spriteSize / 2.0f;
+
+	int kinds = static_cast<int>(HintKind::HINT_KIND_COUNT);
+	float u0 = static_cast<float>(static_cast<int>(kind)) / kinds;
+	float u1 = static_cast<float>(static_cast<int>(kind) + 1) / kinds;
+
+	SDL_Vertex* quad = &vertices[count * 4];
+	quad[0] = { { centerX - half, centerY - half }, color, { u0, 0.0f } };
+	quad[1] = { { centerX + half, centerY - half }, color, { u1, 0.0f } };
+	quad[2] = { { centerX + half, centerY + half }, color, { u1, 1.0f } };
+	quad[3] = { { centerX - half, centerY + half }, color, { u0, 1.0f } };
+	count++;
+}
+
+void HintSprites::Draw(SDL_Renderer* renderer) {
+	if (count == 0 || !texture) return;
+
+	// Two triangles per quad, built on first use
+	if (indices.empty()) {
+		indices.resize(HINT_CAPACITY * 6);
+		for (int quad = 0; quad < HINT_CAPACITY; quad++) {
+			int first = quad * 4;
+			int* index = &indices[quad * 6];
+			index[0] = first;
+			index[1] = first + 1;
+			index[2] = first + 2;
+			index[3] = first;
+			index[4] = first + 2;
+			index[5] = first + 3;
+		}
+	}
+
+	SDL_RenderGeometry(renderer, texture, vertices.data(), count * 4, indices.data(), count * 6);
+	Profiler::CountDrawCall();
+}
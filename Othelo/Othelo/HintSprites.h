@@ -0,0 +1,32 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+
+#define HINT_SUPERSAMPLING      4       // Samples per pixel side for the anti-aliased edges
+
+enum class HintKind {
+	DOT,            // Filled dot
+	RING,           // Outline (legal move hints)
+	EVALUATION,     // Filled dot with a dark border, meant to be tinted by a move score
+	HINT_KIND_COUNT
+};
+
+// Move hint markers, rasterized with anti-aliasing once per cell size into one texture.
+// The markers are white and take their color from the vertices, so one texture serves
+// every color, and a frame's hints go out in one SDL_RenderGeometry call.
+class HintSprites {
+public:
+	static void Rebuild(SDL_Renderer* renderer);
+	static void Shutdown();
+
+	static void Begin();
+	static void Add(int row, int col, HintKind kind, SDL_Color color);
+	static void Draw(SDL_Renderer* renderer);
+
+private:
+	static SDL_Texture* texture;
+	static int spriteSize;
+	static std::vector<SDL_Vertex> vertices;
+	static std::vector<int> indices;
+	static int count;
+};
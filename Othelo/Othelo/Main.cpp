@@ -6,15 +6,26 @@
 #include <vector>
 #include <chrono>
 #include <thread>
+#include <future>
+#include <cstring>
 #include "Main.h"
 #include "Title.h"
 #include "Cheats.h"
 #include "Sound.h"
+#include "TextCache.h"
+#include "Animation.h"
+#include "BoardLayer.h"
+#include "PieceBatch.h"
+#include "HintSprites.h"
+#include "Profiler.h"
+#include "GameRecord.h"
+#include "ReplayScreen.h"
 #include "AI.h"
 
 using namespace std;
 
 // Screen size variables
+int GRID_SIZE = BOARD_SIZE;
 int WINDOW_WIDTH = MIN_WINDOW_WIDTH;
 int WINDOW_HEIGHT = MIN_WINDOW_HEIGHT;
 int CELL_SIZE = 40;
@@ -33,19 +44,39 @@ SDL_Event event;
 bool quit = false;
 
 // Game state
-vector<vector<char>> board(GRID_SIZE, vector<char>(GRID_SIZE, ' '));  // 8x8 grid
+unique_ptr<VariantGame> game;        // Position and AI of the board size in play
 char currentPlayer = 'B';  // B (Black) starts first
 bool gameOver = false;
 int blackScore = 2;
 int whiteScore = 2;
-vector<pair<int, int>> validMoves;   // Valid moves
-bool passTurn = false;               // Flag for turn passing
+CellSet validMoves;                  // Valid moves for the current player
+bool passTurn = false;               // The previous player had no move and passed
 Uint32 gameOverTime = 0;
+GameRecord gameRecord;               // Moves of the current game, for save/resume and replay
+const char* statusMessage = nullptr; // Save/load feedback, shown until the next move
 Language currentLanguage = Language::Japanese;
 GameMode currentGameMode = GameMode::TwoPlayers;
+AIDifficulty currentAIDifficulty = AIDifficulty::MEDIUM;
 
 // Animation variables
-vector<PieceAnimation> activeAnimations;
+AnimationTimeline animations;
+PieceBatch pieceBatch;               // Disc vertices, reused every frame
+
+// AI player of the standard board (keeps its search tables between moves, searches on a worker thread),
+// the other sizes have their own AI in the game
+AI ai(AIDifficulty::MEDIUM);
+future<pair<int, int>> aiMove;       // Pending AI search, invalid when the AI is idle
+Uint32 aiSearchStartTime = 0;
+
+// Redraw scheduling: frames are only drawn when something on screen changes
+bool needsRedraw = true;             // State changed since the last frame
+bool windowVisible = true;           // Nothing is drawn while minimized or hidden
+Uint32 lastFrameTime = 0;
+static const Uint32 WAIT_FOREVER = 0xFFFFFFFF;
+
+void RequestRedraw() {
+	needsRedraw = true;
+}
 
 int GetRelativeX(float percentage) {
 	return static_cast<int>(WINDOW_WIDTH * percentage);
@@ -59,161 +90,183 @@ void SetWindowMinMaxSize(SDL_Window* window) {
 	SDL_SetWindowMinimumSize(window, MIN_WINDOW_WIDTH, MIN_WINDOW_HEIGHT);
 }
 
-void ResetGame() {
-	board = vector<vector<char>>(GRID_SIZE, vector<char>(GRID_SIZE, ' '));
-	int center = GRID_SIZE / 2;
-	board[center - 1][center - 1] = 'W';
-	board[center][center] = 'W';
-	board[center - 1][center] = 'B';
-	board[center][center - 1] = 'B';
+// Cancels a running AI search and waits for the worker to finish
+void CancelAIMove() {
+	if (aiMove.valid()) {
+		game->Stop();
+		aiMove.wait();
+		aiMove = future<pair<int, int>>();
+	}
+}
 
-	currentPlayer = 'B';
-	gameOver = false;
-	CountPieces(blackScore, whiteScore); // Update count
-	validMoves.clear();
-	passTurn = false;
-	activeAnimations.clear();
+// Writes the current game to a record file (game records are standard board only)
+bool SaveGame(const char* path) {
+	if (!game->GetStandardBoard()) return false;
+	gameRecord.blackPlayer = RecordPlayer::HUMAN;
+	gameRecord.whitePlayer = (currentGameMode == GameMode::VsAI) ? RecordPlayer::AI : RecordPlayer::HUMAN;
+	gameRecord.whiteLevel = static_cast<uint8_t>(currentAIDifficulty);
+	return gameRecord.Save(path);
 }
 
-bool IsValidMove(int row, int col, char player) {
-	if (board[row][col] != ' ') return false;
+// Recomputes scores, legal moves and pass/game over once per board change, the frame loop only reads them
+void UpdateGameState() {
+	ProfileScope scope(ProfilePhase::UPDATE);
+	RequestRedraw();
+	CountPieces(blackScore, whiteScore);
 
-	char opponent = (player == 'B') ? 'W' : 'B';
-	bool isValid = false;
+	CellSet blackMoves = game->GetValidMoves('B');
+	CellSet whiteMoves = game->GetValidMoves('W');
 
-	// Check all 8 directions
-	for (int dr = -1; dr <= 1; dr++) {
-		for (int dc = -1; dc <= 1; dc++) {
-			if (dr == 0 && dc == 0) continue;
+	if (game->IsFull() || (!blackMoves && !whiteMoves)) {
+		if (!gameOver) {
+			SoundSystem::PlaySound(SoundSystem::GAME_OVER);
+			SaveGame(LAST_GAME_FILE); // Finished games can be replayed from the title screen, the player's save is kept
+		}
+		gameOver = true;
+		gameOverTime = SDL_GetTicks();
+		validMoves = CellSet();
+		return;
+	}
 
-			int r = row + dr;
-			int c = col + dc;
-			bool foundOpponent = false;
+	// A player without moves passes, the message stays up until the next move
+	passTurn = (currentPlayer == 'B') ? !blackMoves : !whiteMoves;
+	if (passTurn) {
+		currentPlayer = OpponentOf(currentPlayer);
+	}
+	validMoves = (currentPlayer == 'B') ? blackMoves : whiteMoves;
+}
 
-			while (r >= 0 && r < GRID_SIZE && c >= 0 && c < GRID_SIZE) {
-				if (board[r][c] == opponent) {
-					foundOpponent = true;
-				}
-				else if (board[r][c] == player && foundOpponent) {
-					isValid = true;
-					break;
-				}
-				else {
-					break;
-				}
+void ResetGame() {
+	CancelAIMove();
+	game->Reset();
 
-				r += dr;
-				c += dc;
-			}
+	currentPlayer = 'B';
+	gameOver = false;
+	animations.Clear();
+	if (game->GetStandardBoard()) gameRecord.Reset(*game->GetStandardBoard(), currentPlayer);
+	statusMessage = nullptr;
+	UpdateGameState();
+}
 
-			if (isValid) break;
-		}
+// Continues the game in SAVE_GAME_FILE from its last move, on the standard board
+void ResumeGame(SDL_Window* window) {
+	GameRecord saved;
+	if (!saved.Load(SAVE_GAME_FILE)) {
+		statusMessage = GetGameStrings(currentLanguage).noSaveMessage;
+		SoundSystem::PlaySound(SoundSystem::INVALID_MOVE);
+		return;
 	}
 
-	return isValid;
-}
+	if (!game->GetStandardBoard()) SetBoardSize(BOARD_SIZE, window);
+	CancelAIMove();
+
+	// Replayed through the game so the moves can be taken back (Load checked they are legal)
+	game->Reset();
+	*game->GetStandardBoard() = saved.start;
+	currentPlayer = saved.startPlayer;
+	for (uint8_t square : saved.moves) {
+		if (!game->GetValidMoves(currentPlayer)) currentPlayer = OpponentOf(currentPlayer);
+		game->MakeMove(square / BOARD_SIZE, square % BOARD_SIZE, currentPlayer);
+		currentPlayer = OpponentOf(currentPlayer);
+	}
+	gameRecord = saved;
+	if (saved.whitePlayer == RecordPlayer::AI && saved.whiteLevel < static_cast<int>(AIDifficulty::DIFFICULTY_COUNT)) {
+		currentGameMode = GameMode::VsAI;
+		currentAIDifficulty = static_cast<AIDifficulty>(saved.whiteLevel);
+	}
+	else {
+		currentGameMode = GameMode::TwoPlayers;
+	}
 
-void FindValidMoves(char player) {
-	validMoves.clear();
+	gameOver = false;
+	animations.Clear();
+	UpdateGameState();
+	statusMessage = GetGameStrings(currentLanguage).resumedMessage;
+	SoundSystem::PlaySound(SoundSystem::MENU_SELECT);
+}
 
-	for (int row = 0; row < GRID_SIZE; row++) {
-		for (int col = 0; col < GRID_SIZE; col++) {
-			if (IsValidMove(row, col, player)) {
-				validMoves.emplace_back(row, col);
-			}
-		}
-	}
+// Reads the cached move set, only valid for the current player
+bool IsValidMove(int row, int col) {
+	return validMoves.Test(row * GRID_SIZE + col);
 }
 
 void CountPieces(int& black, int& white) {
-	black = 0;
-	white = 0;
-
-	for (int row = 0; row < GRID_SIZE; row++) {
-		for (int col = 0; col < GRID_SIZE; col++) {
-			if (board[row][col] == 'B') black++;
-			else if (board[row][col] == 'W') white++;
-		}
-	}
+	black = game->CountPieces('B');
+	white = game->CountPieces('W');
 }
 
 void MakeMove(int row, int col, char player) {
-	if (!IsValidMove(row, col, player)) {
+	// The engine places the disc and flips in a single pass
+	CellSet flips = game->MakeMove(row, col, player);
+	if (!flips) {
 		SoundSystem::PlaySound(SoundSystem::INVALID_MOVE);
 		return;
 	}
 
-	char opponent = (player == 'B') ? 'W' : 'B';
-	board[row][col] = player;
 	SoundSystem::PlaySound(SoundSystem::PIECE_PLACE);
 
-	// Flip pieces in all directions
-	for (int dr = -1; dr <= 1; dr++) {
-		for (int dc = -1; dc <= 1; dc++) {
-			if (dr == 0 && dc == 0) continue;
+	// The board is already committed, animations only replay the flips
+	animations.AddFlips(row * GRID_SIZE + col, flips, OpponentOf(player), player, SDL_GetTicks());
+}
 
-			int r = row + dr;
-			int c = col + dc;
-			vector<pair<int, int>> toFlip;
+// Plays a move for the current player and hands the turn over
+void CommitMove(int row, int col) {
+	MakeMove(row, col, currentPlayer);
+	if (game->GetStandardBoard()) gameRecord.AddMove(row * GRID_SIZE + col);
+	statusMessage = nullptr;
+	currentPlayer = OpponentOf(currentPlayer);
+	UpdateGameState();
+}
 
-			while (r >= 0 && r < GRID_SIZE && c >= 0 && c < GRID_SIZE) {
-				if (board[r][c] == opponent) {
-					toFlip.emplace_back(r, c);
-				}
-				else if (board[r][c] == player) {
-					for (auto& pos : toFlip) {
-						PieceAnimation anim;
-						anim.row = pos.first;
-						anim.col = pos.second;
-						anim.startPiece = opponent;
-						anim.endPiece = player;
-						anim.startTime = SDL_GetTicks();
-						anim.active = true;
-						activeAnimations.push_back(anim);
-					}
-					break;
-				}
-				else {
-					break;
-				}
-				r += dr;
-				c += dc;
-			}
-		}
+// Takes back the last move, against the AI until it is the human's turn again
+void UndoMove() {
+	CancelAIMove();
+	animations.Clear();
+
+	CellMove move;
+	bool undone = false;
+	while (game->Undo(move)) {
+		undone = true;
+		currentPlayer = move.player;
+		if (game->GetStandardBoard() && !gameRecord.moves.empty()) gameRecord.moves.pop_back();
+		// The flipped discs turn back to the opponent
+		animations.AddFlips(move.square, move.flips, move.player, OpponentOf(move.player), SDL_GetTicks());
+		if (currentGameMode != GameMode::VsAI || currentPlayer != 'W') break;
 	}
 
-	// Update count based on actual board
-	CountPieces(blackScore, whiteScore);
+	if (!undone) {
+		SoundSystem::PlaySound(SoundSystem::INVALID_MOVE);
+		return;
+	}
+	SoundSystem::PlaySound(SoundSystem::PIECE_PLACE);
+	statusMessage = nullptr;
+	gameOver = false;
+	UpdateGameState();
 }
 
-void UpdateGameState() {
-	// Update real count
-	CountPieces(blackScore, whiteScore);
-
-	// Check valid moves
-	bool blackCanMove = false, whiteCanMove = false;
-	FindValidMoves('B');
-	blackCanMove = !validMoves.empty();
-	FindValidMoves('W');
-	whiteCanMove = !validMoves.empty();
-
-	if ((blackScore + whiteScore == GRID_SIZE * GRID_SIZE) ||
-		(!blackCanMove && !whiteCanMove)) {
-		gameOver = true;
-		gameOverTime = SDL_GetTicks();
+// Plays an undone move again, against the AI its reply as well
+void RedoMove() {
+	CancelAIMove();
+	animations.Clear();
+
+	CellMove move;
+	bool redone = false;
+	while (game->Redo(move)) {
+		redone = true;
+		currentPlayer = OpponentOf(move.player);
+		if (game->GetStandardBoard()) gameRecord.AddMove(move.square);
+		animations.AddFlips(move.square, move.flips, OpponentOf(move.player), move.player, SDL_GetTicks());
+		if (currentGameMode != GameMode::VsAI || currentPlayer != 'W') break;
 	}
-	else if (currentPlayer == 'B' && !blackCanMove) {
-		passTurn = true;
-		currentPlayer = 'W';
-	}
-	else if (currentPlayer == 'W' && !whiteCanMove) {
-		passTurn = true;
-		currentPlayer = 'B';
-	}
-	else {
-		passTurn = false;
-		FindValidMoves(currentPlayer);
+
+	if (!redone) {
+		SoundSystem::PlaySound(SoundSystem::INVALID_MOVE);
+		return;
 	}
+	SoundSystem::PlaySound(SoundSystem::PIECE_PLACE);
+	statusMessage = nullptr;
+	gameOver = false;
+	UpdateGameState();
 }
 
 void CreatePieceTextures(SDL_Renderer* renderer) {
@@ -226,6 +279,7 @@ void CreatePieceTextures(SDL_Renderer* renderer) {
 
 	// Create texture from surface
 	pieceSpriteSheet = SDL_CreateTextureFromSurface(renderer, surface);
+	Profiler::CountTextureCreated();
 	SDL_FreeSurface(surface);
 
 	if (!pieceSpriteSheet) {
@@ -236,44 +290,11 @@ void CreatePieceTextures(SDL_Renderer* renderer) {
 	SDL_SetTextureBlendMode(pieceSpriteSheet, SDL_BLENDMODE_BLEND);
 }
 
-void RenderPiece(SDL_Renderer* renderer, int row, int col, char piece, float rotationAngle = 0.0f) {
-	int centerX = GRID_OFFSET_X + col * CELL_SIZE + CELL_SIZE / 2;
-	int centerY = GRID_OFFSET_Y + row * CELL_SIZE + CELL_SIZE / 2;
-	int renderSize = CELL_SIZE - 10; // Slightly smaller than cell size
-
-	SDL_Rect* srcRect = (piece == 'B') ? &blackPieceRect : &whitePieceRect;
-
-	SDL_Rect dstRect = {
-		centerX - renderSize / 2,
-		centerY - renderSize / 2,
-		renderSize,
-		renderSize
-	};
-
-	// For flipping animation
-	if (rotationAngle > 0.0f) {
-		float scale = fabs(cos(rotationAngle));
-		dstRect.w = static_cast<int>(renderSize * scale);
-		dstRect.x = centerX - dstRect.w / 2;
-	}
-
-	SDL_Point center = { renderSize / 2, renderSize / 2 };
-	SDL_RenderCopyEx(renderer, pieceSpriteSheet, srcRect, &dstRect,
-		rotationAngle * 180.0f / PI, &center, SDL_FLIP_NONE);
-}
-
 void UpdateAnimations(Uint32 currentTime) {
-	for (auto it = activeAnimations.begin(); it != activeAnimations.end(); ) {
-		float progress = static_cast<float>(currentTime - it->startTime) / ANIMATION_DURATION_MS;
-
-		if (progress >= 1.0f) {
-			board[it->row][it->col] = it->endPiece;
-			it = activeAnimations.erase(it);
-			SoundSystem::PlaySound(SoundSystem::PIECE_FLIP);
-		}
-		else {
-			++it;
-		}
+	// One sound per frame, cascading flips finish a few frames apart
+	if (animations.Update(currentTime) > 0) {
+		SoundSystem::PlaySound(SoundSystem::PIECE_FLIP);
+		RequestRedraw();
 	}
 }
 
@@ -285,22 +306,14 @@ void RenderValidMoves(SDL_Renderer* renderer) {
 		return;
 	}
 
-	SDL_SetRenderDrawColor(renderer, HINT_COLOR);
-
-	for (const auto& move : validMoves) {
-		int x = GRID_OFFSET_X + move.second * CELL_SIZE + CELL_SIZE / 2;
-		int y = GRID_OFFSET_Y + move.first * CELL_SIZE + CELL_SIZE / 2;
-		int radius = 5;
-
-		for (int angle = 0; angle < 360; angle += 10) {
-			double rad = angle * (M_PI / 180.0);
-			int x1 = x + static_cast<int>(std::round(radius * cos(rad)));
-			int y1 = y + static_cast<int>(std::round(radius * sin(rad)));
-			int x2 = x + static_cast<int>(std::round(radius * cos(rad + 0.1)));
-			int y2 = y + static_cast<int>(std::round(radius * sin(rad + 0.1)));
-			SDL_RenderDrawLine(renderer, x1, y1, x2, y2);
-		}
+	// Pre-rasterized rings, all hints in one draw call
+	HintSprites::Begin();
+	CellSet moves = validMoves;
+	while (moves) {
+		int square = PopLowestBit(moves);
+		HintSprites::Add(square / GRID_SIZE, square % GRID_SIZE, HintKind::RING, { HINT_COLOR });
 	}
+	HintSprites::Draw(renderer);
 }
 
 void RenderGameOver(SDL_Renderer* renderer, TTF_Font* font) {
@@ -311,6 +324,7 @@ void RenderGameOver(SDL_Renderer* renderer, TTF_Font* font) {
 	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 180); // Black with 70% opacity
 	SDL_Rect overlay = { 0, 0, WINDOW_WIDTH, WINDOW_HEIGHT };
 	SDL_RenderFillRect(renderer, &overlay);
+	Profiler::CountDrawCall();
 	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
 
 	char gameOverText[50];
@@ -380,20 +394,104 @@ void HandleWindowResize(SDL_Window* window) {
 	// Center the grid
 	GRID_OFFSET_X = (WINDOW_WIDTH - GRID_WIDTH) / 2;
 	GRID_OFFSET_Y = (WINDOW_HEIGHT - GRID_HEIGHT) / 2; // Offset for UI
+
+	// Font sizes follow the window height
+	TextCache::Invalidate();
+
+	// Static board, disc sprites and hint markers for the new cell size
+	BoardLayer::Rebuild(SDL_GetRenderer(window));
+	HintSprites::Rebuild(SDL_GetRenderer(window));
+}
+
+// Starts a new game on a board of another size (6, 8 or 10) and lays the board out again
+void SetBoardSize(int size, SDL_Window* window) {
+	if (game) CancelAIMove();
+	unique_ptr<VariantGame> sized = CreateVariantGame(size, ai);
+	if (!sized) return;
+
+	game = std::move(sized);
+	GRID_SIZE = size;
+	HandleWindowResize(window);
+	ResetGame();
+}
+
+void HandleWindowEvent(const SDL_Event& windowEvent, SDL_Window* window) {
+	switch (windowEvent.window.event) {
+	case SDL_WINDOWEVENT_RESIZED:
+		HandleWindowResize(window);
+		break;
+	case SDL_WINDOWEVENT_MINIMIZED:
+	case SDL_WINDOWEVENT_HIDDEN:
+		windowVisible = false;
+		break;
+	case SDL_WINDOWEVENT_RESTORED:
+	case SDL_WINDOWEVENT_MAXIMIZED:
+	case SDL_WINDOWEVENT_SHOWN:
+	case SDL_WINDOWEVENT_EXPOSED:
+		windowVisible = true;
+		break;
+	}
+}
+
+// Next time the screen changes without any event (animations, blinking text, countdowns)
+Uint32 NextRedrawTime(GameState currentState) {
+	if (currentState == GameState::REPLAY_SCREEN) return WAIT_FOREVER; // Only changes on input
+	if (currentState == GameState::TITLE_SCREEN) {
+		int animationStep = (lastFrameTime % TITLE_FULL_CYCLE_DURATION) / TITLE_ANIMATION_STEP_DURATION;
+		if (animationStep == 4) return lastFrameTime + FRAME_INTERVAL_MS; // Flipping piece
+
+		Uint32 nextBlink = (lastFrameTime / BLINK_INTERVAL_MS + 1) * BLINK_INTERVAL_MS;
+		Uint32 nextStep = (lastFrameTime / TITLE_ANIMATION_STEP_DURATION + 1) * TITLE_ANIMATION_STEP_DURATION;
+		return std::min(nextBlink, nextStep);
+	}
+
+	if (!animations.IsEmpty()) return lastFrameTime + FRAME_INTERVAL_MS;
+	if (gameOver) {
+		// Restart countdown, once per second
+		if (lastFrameTime < gameOverTime) return gameOverTime;
+		return gameOverTime + ((lastFrameTime - gameOverTime) / 1000 + 1) * 1000;
+	}
+	return WAIT_FOREVER;
+}
+
+// Next time the game logic has to run without any event
+Uint32 NextUpdateTime(GameState currentState, Uint32 currentTime) {
+	if (currentState != GameState::GAME_SCREEN) return WAIT_FOREVER;
+	if (gameOver) return gameOverTime + RESTART_TIME * 1000;
+
+	// The AI result is polled, the worker thread does not send events
+	if (currentGameMode == GameMode::VsAI && currentPlayer == 'W') return std::max(currentTime + AI_POLL_INTERVAL_MS, aiSearchStartTime + AI_MIN_THINK_TIME_MS);
+	if (!animations.IsEmpty()) return currentTime + FRAME_INTERVAL_MS;
+	return WAIT_FOREVER;
 }
 
 void EventHandler(GameState& currentState, SDL_Window* window) {
 	while (SDL_PollEvent(&event)) {
-		HandleCheatCodes(event, currentState, board, currentPlayer, gameOver);
+		if (event.type != SDL_MOUSEMOTION) {
+			RequestRedraw();
+		}
+
+		// Cheats edit the board directly, so the cached state is refreshed when they change anything
+		CellSet blackBefore = game->GetPieces('B');
+		CellSet whiteBefore = game->GetPieces('W');
+		char playerBefore = currentPlayer;
+		HandleCheatCodes(event, currentState, *game, currentPlayer, gameOver);
+		if (game->GetPieces('B') != blackBefore || game->GetPieces('W') != whiteBefore || currentPlayer != playerBefore) {
+			// The record and the takeback history restart from the edited position, moves before it cannot lead there
+			if (game->GetStandardBoard()) gameRecord.Reset(*game->GetStandardBoard(), currentPlayer);
+			game->ClearHistory();
+			UpdateGameState();
+		}
 
 		if (event.type == SDL_QUIT) {
 			quit = true;
 		}
 		else if (event.type == SDL_WINDOWEVENT) {
-			if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
-				HandleWindowResize(window);
-				SDL_RenderPresent(SDL_GetRenderer(window));
-			}
+			HandleWindowEvent(event, window);
+		}
+		else if (event.type == SDL_RENDER_TARGETS_RESET) {
+			// The driver lost the render target contents
+			BoardLayer::Rebuild(SDL_GetRenderer(window));
 		}
 		else if (event.type == SDL_KEYDOWN) {
 			switch (event.key.keysym.sym) {
@@ -405,10 +503,37 @@ void EventHandler(GameState& currentState, SDL_Window* window) {
 			case SDLK_ESCAPE:
 				quit = true;
 				break;
+
+			case PROFILER_TOGGLE_KEY:
+				Profiler::ToggleOverlay();
+				break;
+
+			case SDLK_F5:
+				if (SaveGame(SAVE_GAME_FILE)) {
+					statusMessage = GetGameStrings(currentLanguage).savedMessage;
+					SoundSystem::PlaySound(SoundSystem::MENU_SELECT);
+				}
+				else {
+					SoundSystem::PlaySound(SoundSystem::INVALID_MOVE);
+				}
+				break;
+
+			case SDLK_F9:
+				ResumeGame(window);
+				break;
+
+			case SDLK_z:
+				UndoMove();
+				break;
+
+			case SDLK_y:
+				RedoMove();
+				break;
 			}
 		}
-		else if (event.type == SDL_MOUSEBUTTONDOWN && !gameOver && !passTurn) {
-			if (!activeAnimations.empty()) {
+		else if (event.type == SDL_MOUSEBUTTONDOWN && !gameOver) {
+			// Ignore clicks while the AI is thinking
+			if (currentGameMode == GameMode::VsAI && currentPlayer == 'W') {
 				continue;
 			}
 
@@ -421,19 +546,104 @@ void EventHandler(GameState& currentState, SDL_Window* window) {
 				int row = (mouseY - GRID_OFFSET_Y) / CELL_SIZE;
 				int col = (mouseX - GRID_OFFSET_X) / CELL_SIZE;
 
-				if (IsValidMove(row, col, currentPlayer)) {
-					// Atualiza o tabuleiro primeiro
-					MakeMove(row, col, currentPlayer);
-					// Muda o jogador
-					currentPlayer = (currentPlayer == 'B') ? 'W' : 'B';
-					UpdateGameState();
+				if (IsValidMove(row, col)) {
+					CommitMove(row, col);
 				}
 			}
 		}
 	}
 }
 
+void RenderGameScreen(SDL_Renderer* renderer, TTF_Font* font, Uint32 currentTime) {
+	// Background, grid and coordinates (cached layer)
+	BoardLayer::Draw(renderer);
+
+	// Render score
+	char score_text[100];
+	sprintf_s(score_text, GetGameStrings(currentLanguage).scoreText, blackScore, whiteScore);
+	//RenderText(renderer, font, score_text, GetRelativeX(0.02), GetRelativeY(0.02));
+	RenderTextWithSize(renderer, score_text, GetRelativeX(0.02f), GetRelativeY(0.02f), TEXT_SIZE);
+
+	// Draw pieces: every disc goes into one batch, submitted with a single call
+	pieceBatch.Begin();
+	CellSet blackPieces = game->GetPieces('B');
+	CellSet occupied = blackPieces | game->GetPieces('W');
+	while (occupied) {
+		int square = PopLowestBit(occupied);
+		int row = square / GRID_SIZE;
+		int col = square % GRID_SIZE;
+
+		const PieceAnimation* anim = animations.Get(row, col);
+		if (anim) {
+			// Cascading flips may not have started yet (negative elapsed time)
+			float progress = static_cast<float>(static_cast<Sint32>(currentTime - anim->startTime)) / ANIMATION_DURATION_MS;
+			// Garantir que o progresso fique entre 0 e 1
+			progress = std::min(std::max(progress, 0.0f), 1.0f);
+
+			// Determinar qual lado mostrar baseado no progresso
+			char displayPiece = (progress < 0.5f) ? anim->startPiece : anim->endPiece;
+			pieceBatch.Add(row, col, displayPiece, PieceBatch::FlipSquash(progress));
+		}
+		else {
+			pieceBatch.Add(row, col, blackPieces.Test(square) ? 'B' : 'W');
+		}
+	}
+	pieceBatch.Draw(renderer);
+
+	// Show valid moves
+	if (!gameOver) {
+		RenderValidMoves(renderer);
+	}
+
+	// Render current player turn or game over message
+	if (!gameOver) {
+		char playerTurn_text[100];
+		const char* playerName = (currentPlayer == 'B') ?
+			GetGameStrings(currentLanguage).blackMessage :
+			GetGameStrings(currentLanguage).whiteMessage;
+
+		sprintf_s(playerTurn_text, GetGameStrings(currentLanguage).turnText, playerName);
+		//RenderText(renderer, font, playerTurn_text, GetRelativeX(0.45), GetRelativeY(0.02));
+		RenderTextWithSize(renderer, playerTurn_text, GetRelativeX(0.45f), GetRelativeY(0.02f), TEXT_SIZE);
+
+		if (passTurn) {
+			//RenderText(renderer, font, GetGameStrings(currentLanguage).noMovesMessage, GetRelativeX(0.02), GetRelativeY(0.92));
+			RenderTextWithSize(renderer, GetGameStrings(currentLanguage).noMovesMessage, GetRelativeX(0.02f), GetRelativeY(0.87f), TEXT_SIZE);
+		}
+		else if (statusMessage) {
+			RenderTextWithSize(renderer, statusMessage, GetRelativeX(0.02f), GetRelativeY(0.87f), TEXT_SIZE);
+		}
+		RenderTextWithSize(renderer, GetGameStrings(currentLanguage).undoRedoMessage, GetRelativeX(0.70f), GetRelativeY(0.87f), TEXT_SIZE);
+		RenderTextWithSize(renderer, GetGameStrings(currentLanguage).saveLoadMessage, GetRelativeX(0.70f), GetRelativeY(0.92f), TEXT_SIZE);
+
+		//RenderText(renderer, font, GetGameStrings(currentLanguage).returnTitleMessage, GetRelativeX(0.02), GetRelativeY(0.92));
+		RenderTextWithSize(renderer, GetGameStrings(currentLanguage).returnTitleMessage, GetRelativeX(0.02f), GetRelativeY(0.92f), TEXT_SIZE);
+	}
+	else {
+		RenderGameOver(renderer, font);
+	}
+}
+
+// Draws the profiler overlay over the finished frame and presents it
+void PresentFrame(SDL_Renderer* renderer, Uint32 currentTime) {
+	Profiler::DrawOverlay(renderer);
+	{
+		ProfileScope scope(ProfilePhase::PRESENT);
+		SDL_RenderPresent(renderer);
+	}
+	Profiler::EndFrame();
+	needsRedraw = false;
+	lastFrameTime = currentTime;
+}
+
 int main(int argc, char* argv[]) {
+	// --profile-csv <file>: every frame's profiler sample is written to the file on exit
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc) {
+			Profiler::EnableCsv(argv[++i]);
+		}
+	}
+
 	// Initialize SDL
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
 		cout << "SDL Initialization Error: " << SDL_GetError() << endl;
@@ -492,150 +702,121 @@ int main(int argc, char* argv[]) {
 		return -1;
 	}
 
+	// The game still plays without a book, the AI just searches from the first move
+	if (!ai.LoadBook(AI_BOOK_FILE)) {
+		cout << "Opening book not found: " << AI_BOOK_FILE << endl;
+	}
+
+	// Retrained evaluation weights replace the built-in ones when the file is present
+	ai.LoadWeights(AI_WEIGHTS_FILE);
+	ai.LoadNetwork(AI_NETWORK_FILE);
+
+	// Lay out the board for the actual window size, this also builds the cached board layer and starts a game
+	SetBoardSize(GRID_SIZE, window);
+
 	// Game state variables
 	GameState currentState = GameState::TITLE_SCREEN;
-	ResetGame();
 
-	// Main game loop
+	// Main game loop: sleeps until an event arrives or something is due (animation frame, countdown, AI result)
 	while (!quit) {
+		Uint32 now = SDL_GetTicks();
+		Uint32 wakeTime = NextUpdateTime(currentState, now);
+		if (windowVisible) {
+			wakeTime = needsRedraw ? now : std::min(wakeTime, NextRedrawTime(currentState));
+		}
+		if (wakeTime == WAIT_FOREVER) {
+			SDL_WaitEvent(NULL);
+		}
+		else if (wakeTime > now) {
+			SDL_WaitEventTimeout(NULL, static_cast<int>(wakeTime - now));
+		}
+
 		Uint32 currentTime = SDL_GetTicks();
+		if (windowVisible && currentTime >= NextRedrawTime(currentState)) {
+			needsRedraw = true;
+		}
 
 		if (currentState == GameState::TITLE_SCREEN) {
-			HandleTitleScreenEvents(event, currentState, quit, currentLanguage, window);
-			RenderTitleScreen(renderer, font, currentLanguage, currentTime, pieceSpriteSheet);
+			{
+				ProfileScope scope(ProfilePhase::EVENTS);
+				HandleTitleScreenEvents(event, currentState, quit, currentLanguage, window);
+			}
+			if (needsRedraw && windowVisible) {
+				{
+					ProfileScope scope(ProfilePhase::RENDER);
+					RenderTitleScreen(renderer, currentLanguage, currentTime, pieceSpriteSheet);
+				}
+				PresentFrame(renderer, currentTime);
+			}
+		}
+		else if (currentState == GameState::REPLAY_SCREEN) {
+			{
+				ProfileScope scope(ProfilePhase::EVENTS);
+				HandleReplayScreenEvents(event, currentState, quit, window);
+			}
+			if (needsRedraw && windowVisible) {
+				{
+					ProfileScope scope(ProfilePhase::RENDER);
+					RenderReplayScreen(renderer, currentLanguage);
+				}
+				PresentFrame(renderer, currentTime);
+			}
 		}
 		else if (currentState == GameState::GAME_SCREEN) {
-			EventHandler(currentState, window);
-			UpdateAnimations(currentTime);
+			{
+				ProfileScope scope(ProfilePhase::EVENTS);
+				EventHandler(currentState, window);
+			}
+			{
+				ProfileScope scope(ProfilePhase::UPDATE);
+				UpdateAnimations(currentTime);
+			}
 
 			if (!gameOver) {
-				UpdateGameState();
-
-				// Lógica da AI (modo 1 jogador)
-				if (currentGameMode == GameMode::VsAI && currentPlayer == 'W' && !passTurn) {
-					if (activeAnimations.empty()) {
-						AI ai(AIDifficulty::EASY);
-						auto move = ai.MakeMove(board, currentPlayer);
-						if (move.first != -1 && move.second != -1) {
-							MakeMove(move.first, move.second, currentPlayer); // <--- CHANGE IS HERE
-							currentPlayer = 'B'; // AI (White) just moved, so switch to Black
-							UpdateGameState();
+				ProfileScope scope(ProfilePhase::AI);
+
+				// Lógica da AI (modo 1 jogador): a busca roda em outra thread, o loop continua desenhando
+				if (currentGameMode == GameMode::VsAI && currentPlayer == 'W') {
+					if (!aiMove.valid()) {
+						// The board is committed, the search does not wait for the flips to finish on screen
+						aiMove = game->StartSearch(currentPlayer, currentAIDifficulty);
+						aiSearchStartTime = currentTime;
+					}
+					else if (currentTime - aiSearchStartTime >= AI_MIN_THINK_TIME_MS &&
+						aiMove.wait_for(chrono::seconds(0)) == future_status::ready) {
+						auto move = aiMove.get();
+						// The board may have changed under the search (cheats), so check again
+						if (move.first != -1 && currentPlayer == 'W' && IsValidMove(move.first, move.second)) {
+							CommitMove(move.first, move.second);
 						}
 					}
 				}
 			}
 			else {
 				// Lógica de game over
-				Uint32 currentTime = SDL_GetTicks();
+				ProfileScope scope(ProfilePhase::UPDATE);
 				if (currentTime - gameOverTime >= RESTART_TIME * 1000) {
 					ResetGame();
 				}
-				if (gameOver && gameOverTime + 100 > currentTime) {
-					SoundSystem::PlaySound(SoundSystem::GAME_OVER);
-				}
-			}
-
-			// Clear screen (green background)
-			SDL_SetRenderDrawColor(renderer, GAME_BACKGROUND_COLOR);
-			SDL_RenderClear(renderer);
-
-			// Render score
-			char score_text[100];
-			sprintf_s(score_text, GetGameStrings(currentLanguage).scoreText, blackScore, whiteScore);
-			//RenderText(renderer, font, score_text, GetRelativeX(0.02), GetRelativeY(0.02));
-			RenderTextWithSize(renderer, score_text, GetRelativeX(0.02f), GetRelativeY(0.02f), TEXT_SIZE);
-
-			// Draw Grid (dark green lines)
-			SDL_SetRenderDrawColor(renderer, GRID_COLOR);
-			for (int i = 0; i <= GRID_SIZE; i++) {
-				// Vertical lines
-				SDL_RenderDrawLine(
-					renderer,
-					GRID_OFFSET_X + i * CELL_SIZE,
-					GRID_OFFSET_Y,
-					GRID_OFFSET_X + i * CELL_SIZE,
-					GRID_OFFSET_Y + GRID_HEIGHT
-				);
-
-				// Horizontal lines
-				SDL_RenderDrawLine(
-					renderer,
-					GRID_OFFSET_X,
-					GRID_OFFSET_Y + i * CELL_SIZE,
-					GRID_OFFSET_X + GRID_WIDTH,
-					GRID_OFFSET_Y + i * CELL_SIZE
-				);
-			}
-
-			// Draw pieces
-			for (int row = 0; row < GRID_SIZE; row++) {
-				for (int col = 0; col < GRID_SIZE; col++) {
-					bool isAnimating = false;
-					float rotationAngle = 0.0f;
-
-					for (const auto& anim : activeAnimations) {
-						if (anim.row == row && anim.col == col) {
-							isAnimating = true;
-							float progress = static_cast<float>(currentTime - anim.startTime) / ANIMATION_DURATION_MS;
-							// Garantir que o progresso fique entre 0 e 1
-							progress = std::min(std::max(progress, 0.0f), 1.0f);
-							float rotationAngle = progress * PI; // Full flip is 180 degrees
-
-							// Determinar qual lado mostrar baseado no progresso
-							char displayPiece = (progress < 0.5f) ? anim.startPiece : anim.endPiece;
-							RenderPiece(renderer, row, col, displayPiece, rotationAngle);
-							break;
-						}
-					}
-
-					if (!isAnimating && (board[row][col] == 'B' || board[row][col] == 'W')) {
-						RenderPiece(renderer, row, col, board[row][col]);
-					}
-				}
-			}
-
-			// Show valid moves
-			if (!gameOver && !passTurn) {
-				RenderValidMoves(renderer);
 			}
 
-			// Render current player turn or game over message
-			if (!gameOver) {
-				char playerTurn_text[100];
-				const char* playerName = (currentPlayer == 'B') ?
-					GetGameStrings(currentLanguage).blackMessage :
-					GetGameStrings(currentLanguage).whiteMessage;
-
-				sprintf_s(playerTurn_text, GetGameStrings(currentLanguage).turnText, playerName);
-				//RenderText(renderer, font, playerTurn_text, GetRelativeX(0.45), GetRelativeY(0.02));
-				RenderTextWithSize(renderer, playerTurn_text, GetRelativeX(0.45f), GetRelativeY(0.02f), TEXT_SIZE);
-
-				if (passTurn) {
-					//RenderText(renderer, font, GetGameStrings(currentLanguage).noMovesMessage, GetRelativeX(0.02), GetRelativeY(0.92));
-					RenderTextWithSize(renderer, GetGameStrings(currentLanguage).noMovesMessage, GetRelativeX(0.02f), GetRelativeY(0.92f), TEXT_SIZE);
+			if (needsRedraw && windowVisible) {
+				{
+					ProfileScope scope(ProfilePhase::RENDER);
+					RenderGameScreen(renderer, font, currentTime);
 				}
-
-				//RenderText(renderer, font, GetGameStrings(currentLanguage).returnTitleMessage, GetRelativeX(0.02), GetRelativeY(0.92));
-				RenderTextWithSize(renderer, GetGameStrings(currentLanguage).returnTitleMessage, GetRelativeX(0.02f), GetRelativeY(0.92f), TEXT_SIZE);
-			}
-			else {
-				RenderGameOver(renderer, font);
-			}
-
-			SDL_RenderPresent(renderer);
-
-			// Add frame rate limiting (e.g., to 60 FPS)
-			const int FPS = 60;
-			const int frameDelay = 1000 / FPS;
-			Uint32 frameTime = SDL_GetTicks() - currentTime;
-			if (frameDelay > frameTime) {
-				SDL_Delay(frameDelay - frameTime);
+				PresentFrame(renderer, currentTime);
 			}
 		}
 	}
 
 	// Cleanup
+	CancelAIMove();
+	Profiler::Shutdown();
 	SoundSystem::Shutdown();
+	TextCache::Shutdown();
+	BoardLayer::Shutdown();
+	HintSprites::Shutdown();
 	TTF_CloseFont(font);
 	SDL_DestroyRenderer(renderer);
 	SDL_DestroyWindow(window);
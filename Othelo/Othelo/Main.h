@@ -1,5 +1,8 @@
 ﻿#pragma once
 #include <SDL.h>
+#include "Board.h"
+#include "AI.h"
+#include "VariantGame.h"
 #ifdef _DEBUG
 #pragma comment(linker, "/SUBSYSTEM:CONSOLE")
 #else
@@ -11,10 +14,12 @@
 #define ASPECT_RATIO           4.0f/3.0f	// Target aspect ratio
 
 // Game constants
-#define GRID_SIZE               8						// 8x8
 #define RESTART_TIME            3       
+#define PIECE_MARGIN            10						// Cell size minus disc size
 #define TEXT_SIZE               24
 #define TEXT_FONT               "NotoSansJP-Variable.ttf"
+#define SAVE_GAME_FILE          "savegame.orec"		// F5/F9, só o que o jogador salvou
+#define LAST_GAME_FILE          "lastgame.orec"		// Última partida terminada, para o replay
 
 #define GAME_BACKGROUND_COLOR   34, 139, 34, 255		// Verde para tabuleiro de Otelo
 #define BLACK_COLOR             0, 0, 0, 255			// Preto
@@ -23,8 +28,13 @@
 #define HINT_COLOR              255, 255, 0, 150		// Amarelo para jogadas possíveis
 
 #define ANIMATION_DURATION_MS   750					// Duração da animação em milissegundos
+#define ANIMATION_STAGGER_MS    40					// Atraso entre viradas em cascata, por casa de distância
+#define AI_MIN_THINK_TIME_MS    1000				// Tempo mínimo que a IA "pensa" antes de jogar
+#define AI_POLL_INTERVAL_MS     20					// Intervalo de verificação do resultado da IA
+#define FRAME_INTERVAL_MS       16					// ~60 FPS enquanto algo está animando
 #define PI                      3.14159265358979323846f
 
+extern int GRID_SIZE;		// Board size picked on the title screen (6, 8 or 10)
 extern int WINDOW_WIDTH;
 extern int WINDOW_HEIGHT;
 extern int CELL_SIZE;
@@ -37,16 +47,6 @@ extern SDL_Texture* pieceSpriteSheet;
 extern SDL_Rect blackPieceRect;
 extern SDL_Rect whitePieceRect;
 
-// Estrutura para animação de peça
-struct PieceAnimation {
-	int row;
-	int col;
-	char startPiece;
-	char endPiece;
-	Uint32 startTime;
-	bool active;
-};
-
 // Language enumeration
 enum class Language {
 	Japanese,
@@ -63,6 +63,7 @@ enum class GameMode {
 };
 
 extern GameMode currentGameMode;
+extern AIDifficulty currentAIDifficulty;
 
 // Language strings structure
 struct GameStrings {
@@ -77,6 +78,13 @@ struct GameStrings {
 	const char* blackMessage;
 	const char* whiteMessage;
 	const char* gameModeText;
+	const char* savedMessage;
+	const char* resumedMessage;
+	const char* noSaveMessage;
+	const char* saveLoadMessage;
+	const char* undoRedoMessage;
+	const char* replayMoveText;
+	const char* replayHelpMessage;
 };
 
 // English strings
@@ -91,7 +99,14 @@ static const GameStrings ENGLISH_STRINGS = {
 	"No valid moves. Turn passes to opponent.",
 	"Black",
 	"White",
-	"Game Mode: %s (Press P to change)"
+	"Game Mode: %s (Press P to change)",
+	"Game saved. Press F9 to resume it.",
+	"Saved game resumed.",
+	"No saved game.",
+	"[F5] Save  [F9] Load",
+	"[Z] Undo  [Y] Redo",
+	"Move %d / %d",
+	"[Left/Right] Step  [Home/End] Jump  [T] Title"
 };
 
 // Japanese strings
@@ -106,7 +121,14 @@ static const GameStrings JAPANESE_STRINGS = {
 	u8"有効な手がありません。相手の番になります。",
 	u8"黒",
 	u8"白",
-	u8"ゲームモード: %s (Pキーで変更)"
+	u8"ゲームモード: %s (Pキーで変更)",
+	u8"ゲームを保存しました。F9キーで再開できます。",
+	u8"保存したゲームを再開しました。",
+	u8"保存されたゲームがありません。",
+	u8"[F5]保存 [F9]再開",
+	u8"[Z]待った [Y]やり直し",
+	u8"%d / %d 手目",
+	u8"[←/→]1手ずつ [Home/End]最初/最後 [T]タイトル"
 };
 
 // Portuguese strings
@@ -121,7 +143,14 @@ static const GameStrings PORTUGUESE_STRINGS = {
 	"Sem jogadas validas. Turno passa para o oponente.",
 	"Pretas",
 	"Brancas",
-	"Modo de Jogo: %s (Pressione P para mudar)"
+	"Modo de Jogo: %s (Pressione P para mudar)",
+	"Jogo salvo. Pressione F9 para continuar.",
+	"Jogo salvo retomado.",
+	"Nenhum jogo salvo.",
+	"[F5] Salvar  [F9] Carregar",
+	"[Z] Desfazer  [Y] Refazer",
+	"Jogada %d / %d",
+	"[Esq/Dir] Passo  [Home/End] Pular  [T] Titulo"
 };
 
 inline const GameStrings& GetGameStrings(Language lang) {
@@ -140,4 +169,7 @@ inline const GameStrings& GetGameStrings(Language lang) {
 void CountPieces(int& black, int& white);
 int GetRelativeX(float percentage);
 int GetRelativeY(float percentage);
-void HandleWindowResize(SDL_Window* window);
\ No newline at end of file
+void HandleWindowResize(SDL_Window* window);
+void HandleWindowEvent(const SDL_Event& windowEvent, SDL_Window* window);
+void RequestRedraw();
+void SetBoardSize(int size, SDL_Window* window);
\ No newline at end of file
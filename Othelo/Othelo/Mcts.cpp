@@ -0,0 +1,223 @@
+#include "Mcts.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include <utility>
+
+// Node expansion states
+#define MCTS_UNEXPANDED     0
+#define MCTS_EXPANDING      1       // Another thread is creating the children
+#define MCTS_EXPANDED       2
+
+// xorshift64*: a few cycles per number, plenty for random playouts
+static inline uint64_t NextRandom(uint64_t& state) {
+	state ^= state >> 12;
+	state ^= state << 25;
+	state ^= state >> 27;
+	return state * 0x2545F4914F6CDD1DULL;
+}
+
+// Plays random moves to the end of the game, returns the result for the side to move in half points
+static int RandomPlayout(Bitboard player, Bitboard opponent, uint64_t& random) {
+	bool swapped = false;
+	bool passed = false;
+	for (;;) {
+		Bitboard moves = GetMovesMask(player, opponent);
+		if (!moves) {
+			if (passed) break;
+			passed = true;
+			std::swap(player, opponent);
+			swapped = !swapped;
+			continue;
+		}
+		passed = false;
+
+		// Drop a random number of lower moves, then take the lowest one left
+		int skip = static_cast<int>(((NextRandom(random) >> 32) * static_cast<uint64_t>(PopCount(moves))) >> 32);
+		while (skip--) moves &= moves - 1;
+		int square = LowestBitIndex(moves);
+
+		ToggleMove(player, opponent, 1ULL << square, GetFlipsMask(square, player, opponent));
+		std::swap(player, opponent);
+		swapped = !swapped;
+	}
+
+	int diff = PopCount(player) - PopCount(opponent);
+	if (swapped) diff = -diff;
+	return (diff > 0) ? 2 : (diff == 0) ? 1 : 0;
+}
+
+static void InitNode(MctsNode& node, int move) {
+	node.visits.store(0, std::memory_order_relaxed);
+	node.score.store(0, std::memory_order_relaxed);
+	node.virtualLoss.store(0, std::memory_order_relaxed);
+	node.state.store(MCTS_UNEXPANDED, std::memory_order_relaxed);
+	node.childCount = 0;
+	node.move = static_cast<int8_t>(move);
+	node.firstChild = 0;
+}
+
+int MctsSearcher::Search(Bitboard player, Bitboard opponent, int threadCount, uint64_t limit, uint64_t seed) {
+	if (!pool) pool.reset(new MctsNode[MCTS_POOL_NODES]);
+
+	rootPlayer = player;
+	rootOpponent = opponent;
+	playoutLimit = limit;
+	stop = false;
+	sharedPlayouts = 0;
+	playouts = 0;
+	winRate = 0.0;
+
+	// The root is expanded up front, so every thread starts choosing between its moves
+	nextNode = 1;
+	InitNode(pool[0], -1);
+	if (!GetMovesMask(player, opponent) || !Expand(pool[0], player, opponent)) return -1;
+
+	std::vector<std::thread> helpers;
+	for (int i = 1; i < threadCount; i++) {
+		helpers.emplace_back(&MctsSearcher::SearchThread, this, i, seed);
+	}
+	SearchThread(0, seed);
+	for (auto& helper : helpers) helper.join();
+
+	playouts = playoutLimit ? std::min(sharedPlayouts.load(), playoutLimit) : sharedPlayouts.load();
+	const MctsNode& best = pool[MostVisitedChild(pool[0])];
+	uint32_t visits = best.visits.load(std::memory_order_relaxed);
+	winRate = visits ? best.score.load(std::memory_order_relaxed) / (2.0 * visits) : 0.5;
+	return best.move;
+}
+
+void MctsSearcher::SearchThread(int id, uint64_t seed) {
+	uint64_t random = (seed + 1) * 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(id) * 0xD1B54A32D192ED03ULL;
+	if (!random) random = 1;
+
+	while (!stop.load(std::memory_order_relaxed)) {
+		// Playouts are claimed before they run, so a limit is met exactly whatever the thread count
+		uint64_t claimed = sharedPlayouts.fetch_add(MCTS_BATCH_PLAYOUTS, std::memory_order_relaxed);
+		uint64_t batch = MCTS_BATCH_PLAYOUTS;
+		if (playoutLimit) {
+			if (claimed >= playoutLimit) break;
+			batch = std::min(batch, playoutLimit - claimed);
+		}
+		for (uint64_t i = 0; i < batch; i++) RunIteration(random);
+
+		if (playoutLimit && claimed + batch >= playoutLimit) stop = true;
+		if (id == 0 && shouldStop && shouldStop()) stop = true;
+	}
+}
+
+void MctsSearcher::RunIteration(uint64_t& random) {
+	uint32_t path[MCTS_MAX_PATH + 1];
+	int length = 0;
+	Bitboard player = rootPlayer;
+	Bitboard opponent = rootOpponent;
+
+	// Selection: follow the best UCT child while the node has children
+	uint32_t index = 0;
+	path[length++] = index;
+	pool[index].virtualLoss.fetch_add(1, std::memory_order_relaxed);
+	for (;;) {
+		MctsNode& node = pool[index];
+		uint8_t state = node.state.load(std::memory_order_acquire);
+		if (state != MCTS_EXPANDED) {
+			// Expansion: one thread creates the children, the others play out from the leaf meanwhile
+			if (state != MCTS_UNEXPANDED || node.visits.load(std::memory_order_relaxed) < MCTS_EXPAND_VISITS) break;
+			uint8_t expected = MCTS_UNEXPANDED;
+			if (!node.state.compare_exchange_strong(expected, MCTS_EXPANDING, std::memory_order_acquire)) break;
+			if (!Expand(node, player, opponent)) {
+				node.state.store(MCTS_UNEXPANDED, std::memory_order_release);
+				break;
+			}
+		}
+		if (node.childCount == 0 || length > MCTS_MAX_PATH) break;       // Game over
+
+		index = SelectChild(node);
+		MctsNode& child = pool[index];
+		child.virtualLoss.fetch_add(1, std::memory_order_relaxed);
+		path[length++] = index;
+
+		if (child.move >= 0) {
+			ToggleMove(player, opponent, 1ULL << child.move, GetFlipsMask(child.move, player, opponent));
+		}
+		std::swap(player, opponent);
+	}
+
+	// Simulation from the leaf, then backup: each node scores for the side that moved into it
+	int result = 2 - RandomPlayout(player, opponent, random);
+	for (int i = length - 1; i >= 0; i--) {
+		MctsNode& node = pool[path[i]];
+		node.score.fetch_add(static_cast<uint32_t>(result), std::memory_order_relaxed);
+		node.visits.fetch_add(1, std::memory_order_relaxed);
+		node.virtualLoss.fetch_sub(1, std::memory_order_relaxed);
+		result = 2 - result;
+	}
+}
+
+bool MctsSearcher::Expand(MctsNode& node, Bitboard player, Bitboard opponent) {
+	Bitboard moves = GetMovesMask(player, opponent);
+	int count = PopCount(moves);
+	if (!moves && GetMovesMask(opponent, player)) count = 1;     // Pass
+
+	uint32_t first = 0;
+	if (count > 0) {
+		// Once the pool is full the tree just stops growing (checked first so the counter stays bounded)
+		if (nextNode.load(std::memory_order_relaxed) + count > MCTS_POOL_NODES) return false;
+		first = nextNode.fetch_add(static_cast<uint32_t>(count), std::memory_order_relaxed);
+		if (first + count > MCTS_POOL_NODES) return false;
+
+		if (!moves) {
+			InitNode(pool[first], -1);
+		}
+		for (int i = 0; moves; i++) {
+			InitNode(pool[first + i], PopLowestBit(moves));
+		}
+	}
+
+	node.firstChild = first;
+	node.childCount = static_cast<uint8_t>(count);
+	node.state.store(MCTS_EXPANDED, std::memory_order_release);
+	return true;
+}
+
+uint32_t MctsSearcher::SelectChild(const MctsNode& node) const {
+	uint32_t parentVisits = node.visits.load(std::memory_order_relaxed) + node.virtualLoss.load(std::memory_order_relaxed);
+	float logParent = std::log(static_cast<float>(parentVisits + 1));
+
+	uint32_t best = node.firstChild;
+	float bestValue = -1.0f;
+	for (uint32_t i = node.firstChild; i < node.firstChild + node.childCount; i++) {
+		const MctsNode& child = pool[i];
+
+		// A virtual loss counts as a visit that scored nothing
+		uint32_t visits = child.visits.load(std::memory_order_relaxed) + child.virtualLoss.load(std::memory_order_relaxed);
+		if (visits == 0) return i;
+
+		float value = child.score.load(std::memory_order_relaxed) / (2.0f * visits)
+			+ MCTS_EXPLORATION * std::sqrt(logParent / visits);
+		if (value > bestValue) {
+			bestValue = value;
+			best = i;
+		}
+	}
+	return best;
+}
+
+uint32_t MctsSearcher::MostVisitedChild(const MctsNode& node) const {
+	uint32_t best = node.firstChild;
+	for (uint32_t i = node.firstChild + 1; i < node.firstChild + node.childCount; i++) {
+		if (pool[i].visits.load(std::memory_order_relaxed) > pool[best].visits.load(std::memory_order_relaxed)) best = i;
+	}
+	return best;
+}
+
+void MctsSearcher::GetPrincipalVariation(std::vector<int>& moves) const {
+	moves.clear();
+	if (!pool) return;
+
+	const MctsNode* node = &pool[0];
+	while (node->state.load(std::memory_order_acquire) == MCTS_EXPANDED && node->childCount > 0) {
+		node = &pool[MostVisitedChild(*node)];
+		if (node->visits.load(std::memory_order_relaxed) == 0) break;
+		moves.push_back(node->move);
+	}
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Board.h"
+
+#define MCTS_POOL_NODES         (1 << 20)   // Preallocated tree nodes (24 MB), the tree stops growing when they run out
+#define MCTS_EXPAND_VISITS      2           // Visits a leaf needs before its children are created
+#define MCTS_EXPLORATION        1.0f        // UCT exploration constant
+#define MCTS_BATCH_PLAYOUTS     16          // Playouts a thread claims from the shared counter at a time
+#define MCTS_MAX_PATH           (2 * BOARD_CELLS)   // Moves and passes from the root to a leaf
+#define MCTS_SCORE_SCALE        1000        // Reported score = (2 * win rate - 1) * scale
+
+// Tree node. Results are stored for the side that made the move leading to the node.
+// Children of a node are allocated as one block of the pool, so no node is ever freed on its own.
+struct MctsNode {
+	std::atomic<uint32_t> visits;
+	std::atomic<uint32_t> score;            // Half points: 2 per win, 1 per draw
+	std::atomic<uint32_t> virtualLoss;      // Threads currently searching below this node
+	std::atomic<uint8_t> state;             // MCTS_UNEXPANDED, MCTS_EXPANDING, MCTS_EXPANDED
+	uint8_t childCount;
+	int8_t move;                            // Square, -1 for a pass
+	uint32_t firstChild;                    // Pool index, valid once the node is expanded
+};
+
+// Monte Carlo Tree Search with random playouts. All threads share one tree (tree parallelism):
+// a thread descending through a node adds a virtual loss to it, so the others prefer different
+// branches until its result is backed up.
+class MctsSearcher {
+public:
+	MctsSearcher() = default;
+	MctsSearcher(const MctsSearcher&) = delete;
+	MctsSearcher& operator=(const MctsSearcher&) = delete;
+
+	// Searches the side to move's best move until the stop callback returns true or the playout
+	// limit (0 = none) is reached. Returns the most visited move, -1 when the side has to pass.
+	int Search(Bitboard player, Bitboard opponent, int threadCount, uint64_t playoutLimit, uint64_t seed);
+
+	// Polled by the first thread between playout batches, returning true ends the search
+	void SetStopCallback(std::function<bool()> callback) { shouldStop = callback; }
+
+	// Results of the last search
+	uint64_t GetPlayoutCount() const { return playouts; }
+	double GetWinRate() const { return winRate; }       // Of the chosen move, draws count half
+	void GetPrincipalVariation(std::vector<int>& moves) const;
+
+private:
+	std::unique_ptr<MctsNode[]> pool;       // Allocated on the first search
+	std::atomic<uint32_t> nextNode{ 0 };
+	std::atomic<bool> stop{ false };
+	std::atomic<uint64_t> sharedPlayouts{ 0 };
+	std::function<bool()> shouldStop;
+	Bitboard rootPlayer = 0;
+	Bitboard rootOpponent = 0;
+	uint64_t playoutLimit = 0;
+	uint64_t playouts = 0;
+	double winRate = 0.0;
+
+	void SearchThread(int id, uint64_t seed);
+	void RunIteration(uint64_t& random);
+	bool Expand(MctsNode& node, Bitboard player, Bitboard opponent);
+	uint32_t SelectChild(const MctsNode& node) const;
+	uint32_t MostVisitedChild(const MctsNode& node) const;
+};
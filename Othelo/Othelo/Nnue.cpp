@@ -0,0 +1,276 @@
+#include "Nnue.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+#ifdef CPU_X86
+#include <immintrin.h>
+#endif
+
+typedef void (*UpdateFunction)(int16_t* out, const int16_t* in, const int16_t* const* rows, int count);
+typedef int (*ForwardFunction)(const NnueNetwork& network, const int16_t* us, const int16_t* them);
+
+struct KernelFunctions {
+	UpdateFunction update;      // out = in + sum of the rows
+	ForwardFunction forward;    // Layer 1 and output from the two accumulators
+};
+
+static inline int ClipActivation(int value) {
+	return std::max(0, std::min(127, value));
+}
+
+// Output layer, shared by every kernel (32 multiplications)
+static int OutputLayer(const NnueNetwork& network, const int32_t* sums) {
+	int output = network.outputBias;
+	for (int i = 0; i < NNUE_LAYER1; i++) {
+		output += ClipActivation(sums[i] >> NNUE_LAYER1_SHIFT) * network.outputWeights[i];
+	}
+	return output / NNUE_OUTPUT_DIVISOR;
+}
+
+// Portable kernels (int16 sums wrap around like the SIMD ones)
+static void UpdateScalar(int16_t* out, const int16_t* in, const int16_t* const* rows, int count) {
+	for (int i = 0; i < NNUE_HIDDEN; i++) {
+		int value = in[i];
+		for (int row = 0; row < count; row++) value += rows[row][i];
+		out[i] = static_cast<int16_t>(value);
+	}
+}
+
+static int ForwardScalar(const NnueNetwork& network, const int16_t* us, const int16_t* them) {
+	uint8_t input[2 * NNUE_HIDDEN];
+	for (int i = 0; i < NNUE_HIDDEN; i++) {
+		input[i] = static_cast<uint8_t>(ClipActivation(us[i]));
+		input[NNUE_HIDDEN + i] = static_cast<uint8_t>(ClipActivation(them[i]));
+	}
+
+	int32_t sums[NNUE_LAYER1];
+	for (int neuron = 0; neuron < NNUE_LAYER1; neuron++) {
+		const int8_t* weights = network.layer1Weights.data() + neuron * 2 * NNUE_HIDDEN;
+		int32_t sum = network.layer1Bias[neuron];
+		for (int i = 0; i < 2 * NNUE_HIDDEN; i++) sum += input[i] * weights[i];
+		sums[neuron] = sum;
+	}
+	return OutputLayer(network, sums);
+}
+
+#ifdef CPU_X86
+// SSE4.1: the accumulator is 16 registers, kept in registers while the rows are added
+TARGET_SSE41 static void UpdateSse41(int16_t* out, const int16_t* in, const int16_t* const* rows, int count) {
+	const int chunks = NNUE_HIDDEN / 8;
+	__m128i accumulator[chunks];
+	for (int i = 0; i < chunks; i++) accumulator[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in) + i);
+	for (int row = 0; row < count; row++) {
+		const __m128i* weights = reinterpret_cast<const __m128i*>(rows[row]);
+		for (int i = 0; i < chunks; i++) accumulator[i] = _mm_add_epi16(accumulator[i], _mm_loadu_si128(weights + i));
+	}
+	for (int i = 0; i < chunks; i++) _mm_storeu_si128(reinterpret_cast<__m128i*>(out) + i, accumulator[i]);
+}
+
+TARGET_SSE41 static int ForwardSse41(const NnueNetwork& network, const int16_t* us, const int16_t* them) {
+	// Clip to 0..127: the min caps the top, the unsigned saturating pack the bottom
+	const int chunks = 2 * NNUE_HIDDEN / 16;
+	const __m128i limit = _mm_set1_epi16(127);
+	__m128i input[chunks];
+	for (int i = 0; i < chunks; i++) {
+		const int16_t* source = (i < chunks / 2) ? us + i * 16 : them + (i - chunks / 2) * 16;
+		__m128i low = _mm_min_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source)), limit);
+		__m128i high = _mm_min_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + 8)), limit);
+		input[i] = _mm_packus_epi16(low, high);
+	}
+
+	// uint8 x int8 pairs never saturate the int16 lanes of maddubs: 2 * 127 * 128 < 32768
+	const __m128i ones = _mm_set1_epi16(1);
+	int32_t sums[NNUE_LAYER1];
+	for (int neuron = 0; neuron < NNUE_LAYER1; neuron++) {
+		const __m128i* weights = reinterpret_cast<const __m128i*>(network.layer1Weights.data() + neuron * 2 * NNUE_HIDDEN);
+		__m128i sum = _mm_setzero_si128();
+		for (int i = 0; i < chunks; i++) {
+			__m128i products = _mm_maddubs_epi16(input[i], _mm_loadu_si128(weights + i));
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(products, ones));
+		}
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+		sums[neuron] = _mm_cvtsi128_si32(sum) + network.layer1Bias[neuron];
+	}
+	return OutputLayer(network, sums);
+}
+
+// AVX2: same as SSE4.1 with twice the width
+TARGET_AVX2 static void UpdateAvx2(int16_t* out, const int16_t* in, const int16_t* const* rows, int count) {
+	const int chunks = NNUE_HIDDEN / 16;
+	__m256i accumulator[chunks];
+	for (int i = 0; i < chunks; i++) accumulator[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in) + i);
+	for (int row = 0; row < count; row++) {
+		const __m256i* weights = reinterpret_cast<const __m256i*>(rows[row]);
+		for (int i = 0; i < chunks; i++) accumulator[i] = _mm256_add_epi16(accumulator[i], _mm256_loadu_si256(weights + i));
+	}
+	for (int i = 0; i < chunks; i++) _mm256_storeu_si256(reinterpret_cast<__m256i*>(out) + i, accumulator[i]);
+}
+
+TARGET_AVX2 static int ForwardAvx2(const NnueNetwork& network, const int16_t* us, const int16_t* them) {
+	// The pack works inside each 128-bit lane, the permute puts the bytes back in input order
+	const int chunks = 2 * NNUE_HIDDEN / 32;
+	const __m256i limit = _mm256_set1_epi16(127);
+	__m256i input[chunks];
+	for (int i = 0; i < chunks; i++) {
+		const int16_t* source = (i < chunks / 2) ? us + i * 32 : them + (i - chunks / 2) * 32;
+		__m256i low = _mm256_min_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)), limit);
+		__m256i high = _mm256_min_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + 16)), limit);
+		input[i] = _mm256_permute4x64_epi64(_mm256_packus_epi16(low, high), 0xD8);
+	}
+
+	const __m256i ones = _mm256_set1_epi16(1);
+	int32_t sums[NNUE_LAYER1];
+	for (int neuron = 0; neuron < NNUE_LAYER1; neuron++) {
+		const __m256i* weights = reinterpret_cast<const __m256i*>(network.layer1Weights.data() + neuron * 2 * NNUE_HIDDEN);
+		__m256i sum = _mm256_setzero_si256();
+		for (int i = 0; i < chunks; i++) {
+			__m256i products = _mm256_maddubs_epi16(input[i], _mm256_loadu_si256(weights + i));
+			sum = _mm256_add_epi32(sum, _mm256_madd_epi16(products, ones));
+		}
+		__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+		sums[neuron] = _mm_cvtsi128_si32(half) + network.layer1Bias[neuron];
+	}
+	return OutputLayer(network, sums);
+}
+
+static const KernelFunctions KERNELS[] = {
+	{ UpdateScalar, ForwardScalar },
+	{ UpdateSse41, ForwardSse41 },
+	{ UpdateAvx2, ForwardAvx2 }
+};
+#else
+static const KernelFunctions KERNELS[] = {
+	{ UpdateScalar, ForwardScalar },
+	{ UpdateScalar, ForwardScalar },
+	{ UpdateScalar, ForwardScalar }
+};
+#endif
+
+NnueEvaluator::NnueEvaluator() {
+	SetKernel(GetBestSimdKernel());
+}
+
+bool NnueEvaluator::SetKernel(SimdKernel newKernel) {
+	if (!IsSimdKernelSupported(newKernel)) return false;
+	kernel = newKernel;
+	return true;
+}
+
+void NnueEvaluator::BuildFlipWeights() {
+	// Row of a square turning to the viewer's color, then of one turning to the opponent's
+	network.flipWeights.resize(network.featureWeights.size());
+	for (int square = 0; square < BOARD_CELLS; square++) {
+		const int16_t* own = &network.featureWeights[square * NNUE_HIDDEN];
+		const int16_t* other = &network.featureWeights[(BOARD_CELLS + square) * NNUE_HIDDEN];
+		for (int i = 0; i < NNUE_HIDDEN; i++) {
+			network.flipWeights[square * NNUE_HIDDEN + i] = static_cast<int16_t>(own[i] - other[i]);
+			network.flipWeights[(BOARD_CELLS + square) * NNUE_HIDDEN + i] = static_cast<int16_t>(other[i] - own[i]);
+		}
+	}
+}
+
+bool NnueEvaluator::LoadWeights(const char* path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	NnueHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+	if (header.magic != NNUE_MAGIC || header.version != NNUE_VERSION) return false;
+	if (header.inputCount != NNUE_INPUTS || header.hiddenCount != NNUE_HIDDEN || header.layer1Count != NNUE_LAYER1) return false;
+
+	NnueNetwork loadedNetwork;
+	loadedNetwork.featureBias.resize(NNUE_HIDDEN);
+	loadedNetwork.featureWeights.resize(NNUE_INPUTS * NNUE_HIDDEN);
+	loadedNetwork.layer1Bias.resize(NNUE_LAYER1);
+	loadedNetwork.layer1Weights.resize(NNUE_LAYER1 * 2 * NNUE_HIDDEN);
+	loadedNetwork.outputWeights.resize(NNUE_LAYER1);
+
+	file.read(reinterpret_cast<char*>(loadedNetwork.featureBias.data()), NNUE_HIDDEN * sizeof(int16_t));
+	file.read(reinterpret_cast<char*>(loadedNetwork.featureWeights.data()), loadedNetwork.featureWeights.size() * sizeof(int16_t));
+	file.read(reinterpret_cast<char*>(loadedNetwork.layer1Bias.data()), NNUE_LAYER1 * sizeof(int32_t));
+	file.read(reinterpret_cast<char*>(loadedNetwork.layer1Weights.data()), loadedNetwork.layer1Weights.size());
+	file.read(reinterpret_cast<char*>(&loadedNetwork.outputBias), sizeof(int32_t));
+	file.read(reinterpret_cast<char*>(loadedNetwork.outputWeights.data()), NNUE_LAYER1);
+	if (!file) return false;
+
+	network = std::move(loadedNetwork);
+	BuildFlipWeights();
+	loaded = true;
+	return true;
+}
+
+bool NnueEvaluator::SaveWeights(const char* path) const {
+	if (!loaded) return false;
+
+	std::ofstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	NnueHeader header = { NNUE_MAGIC, NNUE_VERSION, NNUE_INPUTS, NNUE_HIDDEN, NNUE_LAYER1, 0 };
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(network.featureBias.data()), NNUE_HIDDEN * sizeof(int16_t));
+	file.write(reinterpret_cast<const char*>(network.featureWeights.data()), network.featureWeights.size() * sizeof(int16_t));
+	file.write(reinterpret_cast<const char*>(network.layer1Bias.data()), NNUE_LAYER1 * sizeof(int32_t));
+	file.write(reinterpret_cast<const char*>(network.layer1Weights.data()), network.layer1Weights.size());
+	file.write(reinterpret_cast<const char*>(&network.outputBias), sizeof(int32_t));
+	file.write(reinterpret_cast<const char*>(network.outputWeights.data()), NNUE_LAYER1);
+	return static_cast<bool>(file);
+}
+
+void NnueEvaluator::RandomizeWeights(uint64_t seed) {
+	// Ranges chosen so that the activations spread over the whole 0..127 band
+	std::mt19937_64 random(seed);
+	auto uniform = [&random](int low, int high) { return low + static_cast<int>(random() % static_cast<uint64_t>(high - low + 1)); };
+
+	network.featureBias.resize(NNUE_HIDDEN);
+	network.featureWeights.resize(NNUE_INPUTS * NNUE_HIDDEN);
+	network.layer1Bias.resize(NNUE_LAYER1);
+	network.layer1Weights.resize(NNUE_LAYER1 * 2 * NNUE_HIDDEN);
+	network.outputWeights.resize(NNUE_LAYER1);
+
+	for (int16_t& value : network.featureBias) value = static_cast<int16_t>(uniform(0, 64));
+	for (int16_t& value : network.featureWeights) value = static_cast<int16_t>(uniform(-24, 24));
+	for (int32_t& value : network.layer1Bias) value = uniform(-2048, 2048);
+	for (int8_t& value : network.layer1Weights) value = static_cast<int8_t>(uniform(-8, 8));
+	network.outputBias = 0;
+	for (int8_t& value : network.outputWeights) value = static_cast<int8_t>(uniform(-64, 64));
+
+	BuildFlipWeights();
+	loaded = true;
+}
+
+void NnueEvaluator::ComputeState(Bitboard black, Bitboard white, NnueState& state) const {
+	const int16_t* rows[BOARD_CELLS];
+	for (int view = 0; view < 2; view++) {
+		Bitboard own = (view == 0) ? black : white;
+		Bitboard other = (view == 0) ? white : black;
+		int count = 0;
+		while (own) rows[count++] = &network.featureWeights[PopLowestBit(own) * NNUE_HIDDEN];
+		while (other) rows[count++] = &network.featureWeights[(BOARD_CELLS + PopLowestBit(other)) * NNUE_HIDDEN];
+		KERNELS[static_cast<int>(kernel)].update(state.accumulators[0][view], network.featureBias.data(), rows, count);
+	}
+	state.top = 0;
+}
+
+void NnueEvaluator::MakeMove(NnueState& state, int square, Bitboard flips, int color) const {
+	const int16_t* rows[BOARD_CELLS];
+	const KernelFunctions& functions = KERNELS[static_cast<int>(kernel)];
+	for (int view = 0; view < 2; view++) {
+		// The new disc and the flipped ones become the mover's: own discs for the mover's view
+		int offset = (view == color - 1) ? 0 : BOARD_CELLS;
+		int count = 0;
+		rows[count++] = &network.featureWeights[(offset + square) * NNUE_HIDDEN];
+		Bitboard rest = flips;
+		while (rest) rows[count++] = &network.flipWeights[(offset + PopLowestBit(rest)) * NNUE_HIDDEN];
+		functions.update(state.accumulators[state.top + 1][view], state.accumulators[state.top][view], rows, count);
+	}
+	state.top++;
+}
+
+int NnueEvaluator::Evaluate(const NnueState& state, bool blackToMove) const {
+	const int16_t* us = state.accumulators[state.top][blackToMove ? 0 : 1];
+	const int16_t* them = state.accumulators[state.top][blackToMove ? 1 : 0];
+	return KERNELS[static_cast<int>(kernel)].forward(network, us, them);
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+#include "CpuFeatures.h"
+
+// Quantized neural network evaluation (NNUE style), an alternative to the pattern evaluator.
+//
+//   inputs      128 features per perspective: own disc on a square (0-63), opponent disc (64-127)
+//   accumulator NNUE_HIDDEN int16 per perspective = bias + sum of the weight rows of the active features,
+//               updated incrementally as discs are placed and flipped
+//   layer 1     both accumulators (side to move first) clipped to 0..127 as uint8 -> NNUE_LAYER1 int8 weights,
+//               int32 sums shifted right by NNUE_LAYER1_SHIFT and clipped to 0..127
+//   output      NNUE_LAYER1 int8 weights + int32 bias, divided by NNUE_OUTPUT_DIVISOR
+//
+// The output uses the units of the pattern evaluator, from the side to move's point of view.
+// Inference runs on AVX2 or SSE4.1 when the CPU has them and on portable code otherwise;
+// all kernels give the same result.
+#define NNUE_INPUTS             (2 * BOARD_CELLS)
+#define NNUE_HIDDEN             128
+#define NNUE_LAYER1             32
+#define NNUE_LAYER1_SHIFT       6
+#define NNUE_OUTPUT_DIVISOR     16
+#define NNUE_STACK_SIZE         (BOARD_CELLS + 1)   // Every move adds a disc, so a game never goes deeper
+
+// Weights file: header, then little-endian arrays in this order:
+//   int16 featureBias[NNUE_HIDDEN], int16 featureWeights[NNUE_INPUTS][NNUE_HIDDEN],
+//   int32 layer1Bias[NNUE_LAYER1], int8 layer1Weights[NNUE_LAYER1][2 * NNUE_HIDDEN],
+//   int32 outputBias, int8 outputWeights[NNUE_LAYER1]
+// The trainer has to keep every accumulator sum inside the int16 range.
+#define NNUE_MAGIC              0x45554E4E      // "NNUE"
+#define NNUE_VERSION            1
+
+struct NnueHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t inputCount;
+	uint32_t hiddenCount;
+	uint32_t layer1Count;
+	uint32_t reserved;
+};
+
+// Accumulators of the positions on the current search path, one entry per move made:
+// making a move writes the next entry, undoing it only steps back
+struct NnueState {
+	int16_t accumulators[NNUE_STACK_SIZE][2][NNUE_HIDDEN];     // [ply][0 = black's view, 1 = white's]
+	int top = 0;
+};
+
+struct NnueNetwork {
+	std::vector<int16_t> featureBias;
+	std::vector<int16_t> featureWeights;
+	std::vector<int16_t> flipWeights;       // Own row minus opponent row, so a flip costs one row per perspective
+	std::vector<int32_t> layer1Bias;
+	std::vector<int8_t> layer1Weights;
+	int32_t outputBias = 0;
+	std::vector<int8_t> outputWeights;
+};
+
+class NnueEvaluator {
+public:
+	NnueEvaluator();
+
+	// Returns false (keeping the current network) if the file is missing or does not match this layout
+	bool LoadWeights(const char* path);
+	bool SaveWeights(const char* path) const;
+	bool IsLoaded() const { return loaded; }
+
+	// Small random weights, for the benchmarks and the network checks until a trained network exists
+	void RandomizeWeights(uint64_t seed);
+
+	void ComputeState(Bitboard black, Bitboard white, NnueState& state) const;
+
+	// Incremental updates for a move by black (color 1) or white (color 2)
+	void MakeMove(NnueState& state, int square, Bitboard flips, int color) const;
+	void UndoMove(NnueState& state) const { state.top--; }
+
+	// Score for the side to move
+	int Evaluate(const NnueState& state, bool blackToMove) const;
+
+	// The best kernel of the CPU is picked at construction, the others can be forced for testing
+	bool SetKernel(SimdKernel kernel);
+	SimdKernel GetKernel() const { return kernel; }
+
+private:
+	NnueNetwork network;
+	bool loaded = false;
+	SimdKernel kernel = SimdKernel::SCALAR;
+
+	void BuildFlipWeights();
+};
@@ -0,0 +1,262 @@
+#include "Pattern.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+// Static weights per square (corners good, X/C squares next to empty corners bad)
+const int SQUARE_WEIGHTS[BOARD_CELLS] = {
+	100, -20,  10,   5,   5,  10, -20, 100,
+	-20, -50,  -2,  -2,  -2,  -2, -50, -20,
+	 10,  -2,  -1,  -1,  -1,  -1,  -2,  10,
+	  5,  -2,  -1,  -1,  -1,  -1,  -2,   5,
+	  5,  -2,  -1,  -1,  -1,  -1,  -2,   5,
+	 10,  -2,  -1,  -1,  -1,  -1,  -2,  10,
+	-20, -50,  -2,  -2,  -2,  -2, -50, -20,
+	100, -20,  10,   5,   5,  10, -20, 100
+};
+
+struct PatternShape {
+	int cellCount;
+	int cells[PATTERN_MAX_CELLS];
+};
+
+// One copy of each shape, the others come from the board symmetries
+static const PatternShape SHAPES[PATTERN_SHAPES] = {
+	{ 10, { 9, 0, 1, 2, 3, 4, 5, 6, 7, 14 } },          // Edge with both X squares
+	{ 9,  { 0, 1, 2, 8, 9, 10, 16, 17, 18 } },          // 3x3 corner
+	{ 10, { 0, 1, 2, 3, 4, 8, 9, 10, 11, 12 } },        // 2x5 corner block
+	{ 8,  { 8, 9, 10, 11, 12, 13, 14, 15 } },           // Second row
+	{ 8,  { 16, 17, 18, 19, 20, 21, 22, 23 } },         // Third row
+	{ 8,  { 24, 25, 26, 27, 28, 29, 30, 31 } },         // Fourth row
+	{ 8,  { 0, 9, 18, 27, 36, 45, 54, 63 } },           // Main diagonal
+	{ 7,  { 1, 10, 19, 28, 37, 46, 55 } },              // Diagonals of 7 to 4 squares
+	{ 6,  { 2, 11, 20, 29, 38, 47 } },
+	{ 5,  { 3, 12, 21, 30, 39 } },
+	{ 4,  { 3, 10, 17, 24 } }
+};
+
+struct SquarePattern {
+	uint16_t instance;
+	uint16_t power;         // 3^position of the square inside the instance
+};
+
+static int instanceShape[PATTERN_INSTANCES];
+static int instanceCells[PATTERN_INSTANCES][PATTERN_MAX_CELLS];
+static int shapeOffset[PATTERN_SHAPES];         // Start of each shape's table inside a stage
+static int shapeSize[PATTERN_SHAPES];
+static int weightCount = 0;
+static SquarePattern squarePatterns[BOARD_CELLS][PATTERN_MAX_PER_SQUARE];
+static int squarePatternCount[BOARD_CELLS];
+
+static bool InitPatterns() {
+	int instanceCount = 0;
+	for (int shape = 0; shape < PATTERN_SHAPES; shape++) {
+		int powerOf3 = 1;
+		for (int i = 0; i < SHAPES[shape].cellCount; i++) powerOf3 *= 3;
+		shapeOffset[shape] = weightCount;
+		shapeSize[shape] = powerOf3;
+		weightCount += powerOf3;
+
+		// Every symmetry of the shape, skipping the ones covering the same squares as an earlier copy
+		Bitboard seen[BOARD_SYMMETRIES];
+		int seenCount = 0;
+		for (int symmetry = 0; symmetry < BOARD_SYMMETRIES; symmetry++) {
+			Bitboard squares = 0;
+			for (int i = 0; i < SHAPES[shape].cellCount; i++) {
+				squares |= 1ULL << TransformSquare(SHAPES[shape].cells[i], symmetry);
+			}
+			if (std::find(seen, seen + seenCount, squares) != seen + seenCount) continue;
+			seen[seenCount++] = squares;
+
+			instanceShape[instanceCount] = shape;
+			int power = 1;
+			for (int i = 0; i < SHAPES[shape].cellCount; i++) {
+				int square = TransformSquare(SHAPES[shape].cells[i], symmetry);
+				if (squarePatternCount[square] == PATTERN_MAX_PER_SQUARE) return false;
+				instanceCells[instanceCount][i] = square;
+				squarePatterns[square][squarePatternCount[square]++] = { static_cast<uint16_t>(instanceCount), static_cast<uint16_t>(power) };
+				power *= 3;
+			}
+			instanceCount++;
+		}
+	}
+	return instanceCount == PATTERN_INSTANCES;
+}
+
+// Built on first use: evaluators can be created by globals of other files before this file's statics
+static void EnsurePatterns() {
+	static const bool ready = InitPatterns();
+	(void)ready;
+}
+
+// Squares touching the given discs
+static inline Bitboard Neighbours(Bitboard b) {
+	Bitboard sides = ((b << 1) & 0xFEFEFEFEFEFEFEFEULL) | ((b >> 1) & 0x7F7F7F7F7F7F7F7FULL);
+	Bitboard row = b | sides;
+	return sides | (row << 8) | (row >> 8);
+}
+
+PatternEvaluator::PatternEvaluator() {
+	EnsurePatterns();
+	UseDefaultWeights();
+}
+
+int PatternEvaluator::GetWeightCount() {
+	EnsurePatterns();
+	return weightCount;
+}
+
+void PatternEvaluator::UseDefaultWeights() {
+	// Built-in weights: the square table spread over the patterns covering each square, except that
+	// X and C squares only count as bad while the corner next to them is empty
+	static const int corners[4] = { 0, 7, 56, 63 };
+	int cornerOf[BOARD_CELLS];
+	for (int square = 0; square < BOARD_CELLS; square++) {
+		cornerOf[square] = -1;
+		for (int corner : corners) {
+			int dr = std::abs(square / BOARD_SIZE - corner / BOARD_SIZE);
+			int dc = std::abs(square % BOARD_SIZE - corner % BOARD_SIZE);
+			if (square != corner && dr <= 1 && dc <= 1) cornerOf[square] = corner;
+		}
+	}
+
+	stageCount = 1;
+	weights.assign(weightCount, 0);
+
+	for (int shape = 0; shape < PATTERN_SHAPES; shape++) {
+		// Value of a black disc on each cell of the shape, with the corner empty and taken
+		const PatternShape& cells = SHAPES[shape];
+		double emptyCornerValue[PATTERN_MAX_CELLS];
+		double takenCornerValue[PATTERN_MAX_CELLS];
+		int cornerCell[PATTERN_MAX_CELLS];
+
+		for (int i = 0; i < cells.cellCount; i++) {
+			int square = cells.cells[i];
+			int coverage = squarePatternCount[square];
+			emptyCornerValue[i] = takenCornerValue[i] = static_cast<double>(SQUARE_WEIGHTS[square]) / coverage;
+			cornerCell[i] = -1;
+
+			int corner = cornerOf[square];
+			if (corner < 0) continue;
+			for (int j = 0; j < cells.cellCount; j++) {
+				if (cells.cells[j] == corner) cornerCell[i] = j;
+			}
+			if (cornerCell[i] < 0) continue;
+
+			// Patterns holding the corner cancel the penalty of the ones that cannot see it
+			int withCorner = 0;
+			for (int k = 0; k < squarePatternCount[square]; k++) {
+				const int* instance = instanceCells[squarePatterns[square][k].instance];
+				int count = SHAPES[instanceShape[squarePatterns[square][k].instance]].cellCount;
+				if (std::find(instance, instance + count, corner) != instance + count) withCorner++;
+			}
+			takenCornerValue[i] = -static_cast<double>(SQUARE_WEIGHTS[square]) * (coverage - withCorner) / (static_cast<double>(coverage) * withCorner);
+		}
+
+		for (int index = 0; index < shapeSize[shape]; index++) {
+			int codes[PATTERN_MAX_CELLS];
+			for (int i = 0, rest = index; i < cells.cellCount; i++, rest /= 3) codes[i] = rest % 3;
+
+			double value = 0.0;
+			for (int i = 0; i < cells.cellCount; i++) {
+				if (codes[i] == 0) continue;
+				bool cornerTaken = cornerCell[i] >= 0 && codes[cornerCell[i]] != 0;
+				double cellValue = cornerTaken ? takenCornerValue[i] : emptyCornerValue[i];
+				value += (codes[i] == 1) ? cellValue : -cellValue;
+			}
+			weights[shapeOffset[shape] + index] = static_cast<int16_t>(std::lround(value));
+		}
+	}
+}
+
+bool PatternEvaluator::LoadWeights(const char* path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	PatternWeightsHeader header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header))) return false;
+	if (header.magic != PATTERN_WEIGHTS_MAGIC || header.version != PATTERN_WEIGHTS_VERSION) return false;
+	if (header.stageCount < 1 || header.stageCount > PATTERN_MAX_STAGES) return false;
+	if (header.weightCount != static_cast<uint32_t>(weightCount)) return false;
+
+	std::vector<int16_t> loaded(size_t(header.stageCount) * weightCount);
+	if (!file.read(reinterpret_cast<char*>(loaded.data()), loaded.size() * sizeof(int16_t))) return false;
+
+	weights.swap(loaded);
+	stageCount = static_cast<int>(header.stageCount);
+	return true;
+}
+
+bool PatternEvaluator::SaveWeights(const char* path) const {
+	std::ofstream file(path, std::ios::binary);
+	if (!file) return false;
+
+	PatternWeightsHeader header = { PATTERN_WEIGHTS_MAGIC, PATTERN_WEIGHTS_VERSION, static_cast<uint32_t>(stageCount), static_cast<uint32_t>(weightCount) };
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(weights.data()), weights.size() * sizeof(int16_t));
+	return static_cast<bool>(file);
+}
+
+void PatternEvaluator::ComputeState(Bitboard black, Bitboard white, PatternState& state) const {
+	for (int instance = 0; instance < PATTERN_INSTANCES; instance++) {
+		int index = 0;
+		for (int i = SHAPES[instanceShape[instance]].cellCount - 1; i >= 0; i--) {
+			Bitboard mask = 1ULL << instanceCells[instance][i];
+			index = index * 3 + ((black & mask) ? 1 : (white & mask) ? 2 : 0);
+		}
+		state.indices[instance] = static_cast<uint16_t>(index);
+	}
+}
+
+void PatternEvaluator::MakeMove(PatternState& state, int square, Bitboard flips, int color) const {
+	// The new disc goes from 0 to color, each flipped one from the other color to color
+	for (int k = 0; k < squarePatternCount[square]; k++) {
+		const SquarePattern& pattern = squarePatterns[square][k];
+		state.indices[pattern.instance] = static_cast<uint16_t>(state.indices[pattern.instance] + color * pattern.power);
+	}
+
+	int flipDelta = 2 * color - 3;
+	while (flips) {
+		int flipped = PopLowestBit(flips);
+		for (int k = 0; k < squarePatternCount[flipped]; k++) {
+			const SquarePattern& pattern = squarePatterns[flipped][k];
+			state.indices[pattern.instance] = static_cast<uint16_t>(state.indices[pattern.instance] + flipDelta * pattern.power);
+		}
+	}
+}
+
+void PatternEvaluator::UndoMove(PatternState& state, int square, Bitboard flips, int color) const {
+	for (int k = 0; k < squarePatternCount[square]; k++) {
+		const SquarePattern& pattern = squarePatterns[square][k];
+		state.indices[pattern.instance] = static_cast<uint16_t>(state.indices[pattern.instance] - color * pattern.power);
+	}
+
+	int flipDelta = 2 * color - 3;
+	while (flips) {
+		int flipped = PopLowestBit(flips);
+		for (int k = 0; k < squarePatternCount[flipped]; k++) {
+			const SquarePattern& pattern = squarePatterns[flipped][k];
+			state.indices[pattern.instance] = static_cast<uint16_t>(state.indices[pattern.instance] - flipDelta * pattern.power);
+		}
+	}
+}
+
+int PatternEvaluator::Evaluate(const PatternState& state, Bitboard player, Bitboard opponent, bool blackToMove) const {
+	Bitboard occupied = player | opponent;
+	int stage = (PopCount(occupied) - 4) * stageCount / 61;
+	stage = std::max(0, std::min(stageCount - 1, stage));
+	const int16_t* table = weights.data() + size_t(stage) * weightCount;
+
+	int score = 0;
+	for (int instance = 0; instance < PATTERN_INSTANCES; instance++) {
+		score += table[shapeOffset[instanceShape[instance]] + state.indices[instance]];
+	}
+	if (!blackToMove) score = -score;
+
+	// Mobility now, and potential mobility (empty squares next to the opponent) for later
+	Bitboard empty = ~occupied;
+	int mobility = PopCount(GetMovesMask(player, opponent)) - PopCount(GetMovesMask(opponent, player));
+	int potential = PopCount(Neighbours(opponent) & empty) - PopCount(Neighbours(player) & empty);
+
+	return score + PATTERN_MOBILITY_WEIGHT * mobility + PATTERN_POTENTIAL_WEIGHT * potential;
+}
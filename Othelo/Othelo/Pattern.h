@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Board.h"
+
+// Pattern evaluation: the board is cut into lines and corner blocks, each one is read as a
+// base-3 number (0 = empty, 1 = black, 2 = white) and looks up a weight table.
+// Symmetric copies of a pattern share the same table.
+
+#define PATTERN_SHAPES          11
+#define PATTERN_INSTANCES       46      // All symmetric copies of every shape
+#define PATTERN_MAX_CELLS       10
+#define PATTERN_MAX_PER_SQUARE  8       // Instances covering one square
+
+#define PATTERN_MOBILITY_WEIGHT     8   // Per legal move more than the opponent
+#define PATTERN_POTENTIAL_WEIGHT    3   // Per empty square next to an opponent disc
+
+// Evaluator units worth one disc of final difference: the slope of depth 6 search scores against
+// the final results of self-play games (plies 10-40). Converts disc counts into search scores.
+#define PATTERN_SCORE_PER_DISC      7
+
+// Static weights per square (the base of the built-in pattern weights, also used for move ordering)
+extern const int SQUARE_WEIGHTS[BOARD_CELLS];
+
+// Weights file: header, then stageCount * PATTERN_WEIGHT_COUNT little-endian int16 weights,
+// from black's point of view. Stage s covers the positions with (discs - 4) * stageCount / 61 == s.
+#define PATTERN_WEIGHTS_MAGIC       0x53544757      // "WGTS"
+#define PATTERN_WEIGHTS_VERSION     1
+#define PATTERN_MAX_STAGES          61
+
+struct PatternWeightsHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t stageCount;
+	uint32_t weightCount;       // Per stage, must match the pattern layout of this build
+};
+
+// Base-3 index of every pattern instance, updated as moves are made and undone
+struct PatternState {
+	uint16_t indices[PATTERN_INSTANCES];
+};
+
+class PatternEvaluator {
+public:
+	PatternEvaluator();
+
+	// Replaces the built-in weights, returns false (keeping the current ones) if the file is missing or does not match
+	bool LoadWeights(const char* path);
+	void UseDefaultWeights();
+	bool SaveWeights(const char* path) const;       // The starting point for retraining (CLI export-weights)
+
+	void ComputeState(Bitboard black, Bitboard white, PatternState& state) const;
+
+	// Incremental updates for a move by black (color 1) or white (color 2)
+	void MakeMove(PatternState& state, int square, Bitboard flips, int color) const;
+	void UndoMove(PatternState& state, int square, Bitboard flips, int color) const;
+
+	// Score for the side to move
+	int Evaluate(const PatternState& state, Bitboard player, Bitboard opponent, bool blackToMove) const;
+
+	static int GetWeightCount();
+
+private:
+	std::vector<int16_t> weights;       // stageCount blocks of GetWeightCount() weights
+	int stageCount = 1;
+};
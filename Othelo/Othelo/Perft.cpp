@@ -0,0 +1,499 @@
+#include "Perft.h"
+#include "Variant.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Published leaf counts from the start position (passes count as plies), index = depth
+static const uint64_t PERFT_COUNTS[] = {
+	1ULL, 4ULL, 12ULL, 56ULL, 244ULL, 1396ULL, 8200ULL, 55092ULL, 390216ULL, 3005288ULL,
+	24571284ULL, 212258800ULL, 1939886636ULL, 18429641748ULL
+};
+
+static const int PERFT_KNOWN_DEPTH = sizeof(PERFT_COUNTS) / sizeof(PERFT_COUNTS[0]) - 1;
+
+// Regression positions, reached by a move list from the start position. Only the start position has
+// published counts; these were computed by this code and confirmed with a square-by-square
+// implementation of the rules, so they catch changes in move generation away from the start position.
+struct PerftPosition {
+	const char* name;
+	const char* moves;
+	int depth;
+	uint64_t leaves;
+};
+
+static const PerftPosition PERFT_POSITIONS[] = {
+	// The four symmetric openings: each must give a quarter of the start position's depth 9 count,
+	// which checks the generator in every orientation
+	{ "f5", "f5", 8, 751322ULL },
+	{ "d3", "d3", 8, 751322ULL },
+	{ "c4", "c4", 8, 751322ULL },
+	{ "e6", "e6", 8, 751322ULL },
+	// Random games
+	{ "midgame", "d3c5f6d2b5f4d1c4f5g7c3g5e6d7g4h4e7b2a1d8", 6, 751510ULL },
+	{ "late midgame", "e6d6c4f4d7e7f6c7c8d8c6g7h8b6a6b4f3b8e8c5a4f8g3c3f7g6h6h7c2b3g8a5b7g2b2e3", 6, 1746862ULL },
+	{ "endgame (passes)", "d3e3f4c5d2e2f1c1f5e1c4b5d1g5a6c3c6a5g6d7g4h4h3f6b4h7a4f3h6f2b6a7g3h2c7g2g7g8a8b3h1e6b1c8e8h5d8a3c2d6", 9, 149009ULL },
+};
+
+static uint64_t PerftNode(Bitboard player, Bitboard opponent, int depth, bool passed) {
+	if (depth == 0) return 1;
+
+	Bitboard moves = GetMovesMask(player, opponent);
+	if (!moves) {
+		if (passed) return 1; // Game over
+		return PerftNode(opponent, player, depth - 1, true);
+	}
+
+	// Bulk counting: the last ply only needs the number of moves
+	if (depth == 1) return PopCount(moves);
+
+	uint64_t leaves = 0;
+	while (moves) {
+		int square = PopLowestBit(moves);
+		Bitboard flips = GetFlipsMask(square, player, opponent);
+		leaves += PerftNode(opponent & ~flips, player | flips | (1ULL << square), depth - 1, false);
+	}
+	return leaves;
+}
+
+uint64_t Perft(Bitboard player, Bitboard opponent, int depth) {
+	return PerftNode(player, opponent, depth, false);
+}
+
+int RunPerft(int depth) {
+	Board board;
+	board.Reset();
+
+	std::cout << "depth           leaves   time(ms)     Mnps  check\n";
+
+	bool allPassed = true;
+	for (int d = 1; d <= depth; d++) {
+		auto start = std::chrono::steady_clock::now();
+		uint64_t leaves = Perft(board.black, board.white, d);
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		const char* check = "-";
+		if (d <= PERFT_KNOWN_DEPTH) {
+			check = (leaves == PERFT_COUNTS[d]) ? "ok" : "FAIL";
+			if (leaves != PERFT_COUNTS[d]) allPassed = false;
+		}
+
+		std::cout << std::setw(5) << d
+			<< std::setw(17) << leaves
+			<< std::setw(11) << std::fixed << std::setprecision(1) << ms
+			<< std::setw(9) << std::setprecision(2) << leaves / std::max(ms, 0.001) / 1000.0
+			<< "  " << check << "\n";
+	}
+
+	std::cout << "\nregression        depth           leaves   time(ms)  check\n";
+	for (const PerftPosition& position : PERFT_POSITIONS) {
+		Board test;
+		test.Reset();
+		char player = BLACK_PIECE;
+		PlayMoveSequence(test, player, position.moves);
+
+		auto start = std::chrono::steady_clock::now();
+		uint64_t leaves = Perft(test.Pieces(player), test.Pieces(OpponentOf(player)), position.depth);
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+		if (leaves != position.leaves) allPassed = false;
+
+		std::cout << std::left << std::setw(18) << position.name << std::right
+			<< std::setw(5) << position.depth
+			<< std::setw(17) << leaves
+			<< std::setw(11) << std::fixed << std::setprecision(1) << ms
+			<< "  " << (leaves == position.leaves ? "ok" : "FAIL") << "\n";
+	}
+
+	return allPassed ? 0 : 1;
+}
+
+// Reference rules: walks every direction square by square on a plain grid, like the original game code
+struct ReferenceBoard {
+	char cells[BOARD_SIZE][BOARD_SIZE];
+
+	explicit ReferenceBoard(const Board& board) {
+		for (int row = 0; row < BOARD_SIZE; row++) {
+			for (int col = 0; col < BOARD_SIZE; col++) cells[row][col] = board.GetPiece(row, col);
+		}
+	}
+
+	// Discs flipped by a move at (row, col), 0 if the move is illegal
+	Bitboard Flips(int row, int col, char player) const {
+		if (cells[row][col] != EMPTY_PIECE) return 0;
+
+		char opponent = OpponentOf(player);
+		Bitboard flips = 0;
+		for (int dr = -1; dr <= 1; dr++) {
+			for (int dc = -1; dc <= 1; dc++) {
+				if (dr == 0 && dc == 0) continue;
+
+				Bitboard run = 0;
+				int r = row + dr;
+				int c = col + dc;
+				while (r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE && cells[r][c] == opponent) {
+					run |= SquareMask(r, c);
+					r += dr;
+					c += dc;
+				}
+				if (run && r >= 0 && r < BOARD_SIZE && c >= 0 && c < BOARD_SIZE && cells[r][c] == player) flips |= run;
+			}
+		}
+		return flips;
+	}
+};
+
+// Takes every move of a finished game back through its MoveStack, then plays them all again.
+// Each undo has to restore the position before the move, each redo the position after it.
+template <typename BoardType, int Capacity>
+static bool CheckTakeback(BoardType& board, MoveStack<BoardType, Capacity>& history, const std::vector<BoardType>& before) {
+	int plies = static_cast<int>(before.size());
+	if (history.GetCount() != plies || history.CanRedo()) return false;
+
+	BoardType end = board;
+	for (int ply = plies - 1; ply >= 0; ply--) {
+		if (!history.Undo(board) || board.black != before[ply].black || board.white != before[ply].white) return false;
+	}
+	if (history.CanUndo()) return false;
+
+	for (int ply = 0; ply < plies; ply++) {
+		const BoardType& after = (ply + 1 < plies) ? before[ply + 1] : end;
+		if (!history.Redo(board) || board.black != after.black || board.white != after.white) return false;
+	}
+	return !history.CanRedo() && history.GetCount() == plies;
+}
+
+static int CheckRules(int games, unsigned seed) {
+	std::mt19937 random(seed);
+	uint64_t positions = 0;
+
+	for (int game = 0; game < games; game++) {
+		Board board;
+		board.Reset();
+		char player = BLACK_PIECE;
+		int passes = 0;
+		MoveStack<Board, BOARD_CELLS> history;
+		std::vector<Board> before;
+
+		while (passes < 2) {
+			ReferenceBoard reference(board);
+			Bitboard moves = board.GetValidMoves(player);
+			positions++;
+
+			for (int square = 0; square < BOARD_CELLS; square++) {
+				int row = square / BOARD_SIZE;
+				int col = square % BOARD_SIZE;
+				Bitboard expected = reference.Flips(row, col, player);
+				bool legal = (moves >> square) & 1;
+				Bitboard flips = legal ? GetFlipsMask(square, board.Pieces(player), board.Pieces(OpponentOf(player))) : 0;
+
+				if (legal != (expected != 0) || legal != board.IsValidMove(row, col, player) || flips != expected) {
+					std::cerr << "Rules mismatch in game " << game << " at " << SquareName(square) << "\n";
+					return 1;
+				}
+			}
+
+			if (!moves) {
+				passes++;
+				player = OpponentOf(player);
+				continue;
+			}
+			passes = 0;
+
+			std::vector<int> squares;
+			while (moves) squares.push_back(PopLowestBit(moves));
+			int square = squares[random() % squares.size()];
+			before.push_back(board);
+			history.Push(square, board.MakeMove(square / BOARD_SIZE, square % BOARD_SIZE, player), player);
+			player = OpponentOf(player);
+		}
+
+		if (!CheckTakeback(board, history, before)) {
+			std::cerr << "Undo/redo mismatch in game " << game << "\n";
+			return 1;
+		}
+	}
+
+	std::cout << "Rules check passed (" << GetSimdKernelName(GetMoveGenKernel()) << "): " << games << " games, " << positions << " positions\n";
+	return 0;
+}
+
+int RunRulesCheck(int games, unsigned seed) {
+	// Every move generation kernel of this CPU plays the same games
+	SimdKernel selected = GetMoveGenKernel();
+	int result = 0;
+	for (SimdKernel kernel : { SimdKernel::SCALAR, SimdKernel::SSE41, SimdKernel::AVX2 }) {
+		if (!SetMoveGenKernel(kernel)) continue;
+		if (CheckRules(games, seed) != 0) {
+			std::cerr << "Kernel: " << GetSimdKernelName(kernel) << "\n";
+			result = 1;
+			break;
+		}
+	}
+	SetMoveGenKernel(selected);
+	return result;
+}
+
+int RunMoveGenBenchmark(int positions, unsigned seed) {
+	// Positions from random games, so every stage of the game is represented
+	std::mt19937 random(seed);
+	std::vector<std::pair<Bitboard, Bitboard>> samples;
+	while (static_cast<int>(samples.size()) < positions) {
+		Board board;
+		board.Reset();
+		char player = BLACK_PIECE;
+		while (static_cast<int>(samples.size()) < positions) {
+			Bitboard moves = board.GetValidMoves(player);
+			if (!moves) {
+				player = OpponentOf(player);
+				moves = board.GetValidMoves(player);
+				if (!moves) break;
+			}
+			samples.push_back({ board.Pieces(player), board.Pieces(OpponentOf(player)) });
+
+			std::vector<int> squares;
+			while (moves) squares.push_back(PopLowestBit(moves));
+			int square = squares[random() % squares.size()];
+			board.MakeMove(square / BOARD_SIZE, square % BOARD_SIZE, player);
+			player = OpponentOf(player);
+		}
+	}
+
+	const int rounds = 20;
+	uint64_t moveCalls = uint64_t(rounds) * samples.size();
+	SimdKernel selected = GetMoveGenKernel();
+
+	// The portable kernel gives the reference results
+	SetMoveGenKernel(SimdKernel::SCALAR);
+	std::vector<Bitboard> referenceMoves;
+	std::vector<Bitboard> referenceFlips;
+	for (const auto& sample : samples) {
+		Bitboard moves = GetMovesMask(sample.first, sample.second);
+		referenceMoves.push_back(moves);
+		while (moves) referenceFlips.push_back(GetFlipsMask(PopLowestBit(moves), sample.first, sample.second));
+	}
+
+	std::cout << "Move generation benchmark, " << samples.size() << " positions x " << rounds << " rounds\n";
+	std::cout << "kernel   GetMovesMask M/s  ns/call   GetFlipsMask M/s  ns/call  results\n";
+
+	bool allMatch = true;
+	for (SimdKernel kernel : { SimdKernel::SCALAR, SimdKernel::SSE41, SimdKernel::AVX2 }) {
+		if (!SetMoveGenKernel(kernel)) {
+			std::cout << std::left << std::setw(8) << GetSimdKernelName(kernel) << std::right << " not supported by this CPU\n";
+			continue;
+		}
+
+		bool match = true;
+		size_t flipIndex = 0;
+		for (size_t i = 0; i < samples.size(); i++) {
+			Bitboard moves = GetMovesMask(samples[i].first, samples[i].second);
+			if (moves != referenceMoves[i]) match = false;
+			while (moves && match) {
+				if (GetFlipsMask(PopLowestBit(moves), samples[i].first, samples[i].second) != referenceFlips[flipIndex++]) match = false;
+			}
+			if (!match) break;
+		}
+		allMatch = allMatch && match;
+
+		uint64_t checksum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int round = 0; round < rounds; round++) {
+			for (const auto& sample : samples) checksum += GetMovesMask(sample.first, sample.second);
+		}
+		double movesMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		// Flips of the reference moves, so the loop does not pay for move generation
+		uint64_t flipCalls = 0;
+		start = std::chrono::steady_clock::now();
+		for (int round = 0; round < rounds; round++) {
+			for (size_t i = 0; i < samples.size(); i++) {
+				Bitboard moves = referenceMoves[i];
+				while (moves) {
+					checksum += GetFlipsMask(PopLowestBit(moves), samples[i].first, samples[i].second);
+					flipCalls++;
+				}
+			}
+		}
+		double flipsMs = std::max(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(), 0.001);
+		movesMs = std::max(movesMs, 0.001);
+
+		std::cout << std::left << std::setw(8) << GetSimdKernelName(kernel) << std::right
+			<< std::fixed << std::setprecision(2)
+			<< std::setw(18) << moveCalls / movesMs / 1000.0
+			<< std::setw(9) << movesMs * 1e6 / moveCalls
+			<< std::setw(19) << flipCalls / flipsMs / 1000.0
+			<< std::setw(9) << flipsMs * 1e6 / flipCalls
+			<< "  " << (match ? "ok" : "MISMATCH") << "  (checksum " << std::hex << checksum << std::dec << ")\n";
+	}
+
+	SetMoveGenKernel(selected);
+	return allMatch ? 0 : 1;
+}
+
+// Other board sizes: the same checks on the VariantRules templates
+
+template <int Size>
+static uint64_t VariantPerftNode(typename VariantRules<Size>::Bits player, typename VariantRules<Size>::Bits opponent, int depth, bool passed) {
+	typedef VariantRules<Size> Rules;
+	if (depth == 0) return 1;
+
+	typename Rules::Bits moves = Rules::GetMoves(player, opponent);
+	if (!moves) {
+		if (passed) return 1;
+		return VariantPerftNode<Size>(opponent, player, depth - 1, true);
+	}
+	if (depth == 1) return PopCount(moves);
+
+	uint64_t leaves = 0;
+	while (moves) {
+		int square = PopLowestBit(moves);
+		typename Rules::Bits flips = Rules::GetFlips(square, player, opponent);
+		leaves += VariantPerftNode<Size>(opponent & ~flips, player | flips | Rules::SquareBit(square), depth - 1, false);
+	}
+	return leaves;
+}
+
+template <int Size>
+static int VariantPerft(int depth) {
+	VariantBoard<Size> board;
+	board.Reset();
+
+	std::cout << Size << "x" << Size << "\ndepth           leaves   time(ms)     Mnps  check\n";
+
+	bool allPassed = true;
+	for (int d = 1; d <= depth; d++) {
+		auto start = std::chrono::steady_clock::now();
+		uint64_t leaves = VariantPerftNode<Size>(board.black, board.white, d, false);
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		// The standard size has published counts, the others are checked by RunVariantCheck
+		const char* check = "-";
+		if (Size == BOARD_SIZE && d <= PERFT_KNOWN_DEPTH) {
+			check = (leaves == PERFT_COUNTS[d]) ? "ok" : "FAIL";
+			if (leaves != PERFT_COUNTS[d]) allPassed = false;
+		}
+
+		std::cout << std::setw(5) << d
+			<< std::setw(17) << leaves
+			<< std::setw(11) << std::fixed << std::setprecision(1) << ms
+			<< std::setw(9) << std::setprecision(2) << leaves / std::max(ms, 0.001) / 1000.0
+			<< "  " << check << "\n";
+	}
+
+	return allPassed ? 0 : 1;
+}
+
+int RunVariantPerft(int size, int depth) {
+	switch (size) {
+	case 6: return VariantPerft<6>(depth);
+	case 8: return VariantPerft<8>(depth);
+	case 10: return VariantPerft<10>(depth);
+	default:
+		std::cerr << "Board size must be 6, 8 or 10\n";
+		return 1;
+	}
+}
+
+// Square-by-square flips on a board of any size, like ReferenceBoard
+template <int Size>
+static typename VariantRules<Size>::Bits ReferenceVariantFlips(const VariantBoard<Size>& board, int row, int col, char player) {
+	typedef VariantRules<Size> Rules;
+	typename Rules::Bits flips = 0;
+	if (board.GetPiece(row, col) != EMPTY_PIECE) return flips;
+
+	char opponent = OpponentOf(player);
+	for (int dr = -1; dr <= 1; dr++) {
+		for (int dc = -1; dc <= 1; dc++) {
+			if (dr == 0 && dc == 0) continue;
+
+			typename Rules::Bits run = 0;
+			int r = row + dr;
+			int c = col + dc;
+			while (r >= 0 && r < Size && c >= 0 && c < Size && board.GetPiece(r, c) == opponent) {
+				run |= Rules::SquareBit(r * Size + c);
+				r += dr;
+				c += dc;
+			}
+			if (run && r >= 0 && r < Size && c >= 0 && c < Size && board.GetPiece(r, c) == player) flips |= run;
+		}
+	}
+	return flips;
+}
+
+template <int Size>
+static int VariantCheck(int games, unsigned seed) {
+	typedef VariantRules<Size> Rules;
+	typedef typename Rules::Bits Bits;
+	std::mt19937 random(seed);
+	uint64_t positions = 0;
+
+	for (int game = 0; game < games; game++) {
+		VariantBoard<Size> board;
+		board.Reset();
+		char player = BLACK_PIECE;
+		int passes = 0;
+		MoveStack<VariantBoard<Size>, Rules::CELLS> history;
+		std::vector<VariantBoard<Size>> before;
+
+		while (passes < 2) {
+			Bits own = board.Pieces(player);
+			Bits other = board.Pieces(OpponentOf(player));
+			Bits moves = board.GetValidMoves(player);
+			positions++;
+
+			for (int square = 0; square < Rules::CELLS; square++) {
+				Bits expected = ReferenceVariantFlips(board, square / Size, square % Size, player);
+				bool legal = static_cast<bool>(moves & Rules::SquareBit(square));
+				Bits flips = legal ? Rules::GetFlips(square, own, other) : Bits(0);
+
+				// The standard size also has to agree with the bitboard engine
+				bool standardMatch = true;
+				if (Size == BOARD_SIZE) {
+					uint64_t standardOwn = Bitboard128(own).low;
+					uint64_t standardOther = Bitboard128(other).low;
+					standardMatch = (Bitboard128(moves).low == GetMovesMask(standardOwn, standardOther))
+						&& (!legal || Bitboard128(flips).low == GetFlipsMask(square, standardOwn, standardOther));
+				}
+
+				if (legal != static_cast<bool>(expected) || flips != expected || !standardMatch) {
+					std::cerr << Size << "x" << Size << " rules mismatch in game " << game << " at square " << square << "\n";
+					return 1;
+				}
+			}
+
+			if (!moves) {
+				passes++;
+				player = OpponentOf(player);
+				continue;
+			}
+			passes = 0;
+
+			std::vector<int> squares;
+			while (moves) squares.push_back(PopLowestBit(moves));
+			int square = squares[random() % squares.size()];
+			before.push_back(board);
+			history.Push(square, board.MakeMove(square / Size, square % Size, player), player);
+			player = OpponentOf(player);
+		}
+
+		if (!CheckTakeback(board, history, before)) {
+			std::cerr << Size << "x" << Size << " undo/redo mismatch in game " << game << "\n";
+			return 1;
+		}
+	}
+
+	std::cout << Size << "x" << Size << " rules check passed: " << games << " games, " << positions << " positions\n";
+	return 0;
+}
+
+int RunVariantCheck(int size, int games, unsigned seed) {
+	switch (size) {
+	case 6: return VariantCheck<6>(games, seed);
+	case 8: return VariantCheck<8>(games, seed);
+	case 10: return VariantCheck<10>(games, seed);
+	default:
+		std::cerr << "Board size must be 6, 8 or 10\n";
+		return 1;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+#include "Board.h"
+
+// Rules verification and move-generation benchmarks (console output only, no SDL)
+
+// Leaf positions reached after exactly depth plies. A pass counts as a ply,
+// a finished game counts as one leaf wherever it ends.
+uint64_t Perft(Bitboard player, Bitboard opponent, int depth);
+
+// Start position counts to the given depth, checked against the published numbers, then a fixed
+// set of regression positions (the openings, midgames, an endgame with passes) checked against
+// counts computed by this code (no published counts exist for them)
+int RunPerft(int depth);
+
+// Plays random games and compares every legal-move set and flip mask with a
+// square-by-square reference implementation of the rules, once per move generation kernel.
+// Every game is then taken back and replayed through a MoveStack.
+int RunRulesCheck(int games, unsigned seed);
+
+// Raw GetMovesMask / GetFlipsMask throughput of every kernel the CPU supports (scalar, SSE4.1, AVX2)
+// on positions from random games, checked against the scalar results
+int RunMoveGenBenchmark(int positions, unsigned seed);
+
+// Start position counts of a 6x6, 8x8 or 10x10 board with the size-specialized rules (8x8 checked
+// against the published numbers)
+int RunVariantPerft(int size, int depth);
+
+// RunRulesCheck for the size-specialized rules; on 8x8 they also have to match the bitboard engine
+int RunVariantCheck(int size, int games, unsigned seed);
@@ -0,0 +1,79 @@
+#include "PieceBatch.h"
+#include "BoardLayer.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+static float flipSquash[FLIP_SQUASH_STEPS + 1];
+
+static bool InitFlipSquash() {
+	for (int i = 0; i <= FLIP_SQUASH_STEPS; i++) {
+		flipSquash[i] = std::fabs(std::cos(static_cast<float>(i) / FLIP_SQUASH_STEPS * PI));
+	}
+	return true;
+}
+
+float PieceBatch::FlipSquash(float progress) {
+	static const bool ready = InitFlipSquash();
+	(void)ready;
+
+	int step = static_cast<int>(progress * FLIP_SQUASH_STEPS + 0.5f);
+	return flipSquash[std::max(0, std::min(FLIP_SQUASH_STEPS, step))];
+}
+
+PieceBatch::PieceBatch() {
+	vertices.resize(PIECE_BATCH_CAPACITY * 4);
+	indices.resize(PIECE_BATCH_CAPACITY * 6);
+	for (int quad = 0; quad < PIECE_BATCH_CAPACITY; quad++) {
+		int* index = &indices[quad * 6];
+		int first = quad * 4;
+		index[0] = first;
+		index[1] = first + 1;
+		index[2] = first + 2;
+		index[3] = first;
+		index[4] = first + 2;
+		index[5] = first + 3;
+	}
+}
+
+void PieceBatch::Begin() {
+	count = 0;
+	texture = nullptr;
+}
+
+void PieceBatch::Add(int row, int col, char piece, float squash) {
+	if (count == PIECE_BATCH_CAPACITY) return;
+
+	// Both discs live in one texture (pre-scaled sprites or the sprite sheet)
+	SDL_Rect source;
+	SDL_Texture* pieceTexture = BoardLayer::GetPiece(piece, source);
+	if (!pieceTexture) return;
+	if (pieceTexture != texture) {
+		texture = pieceTexture;
+		SDL_QueryTexture(texture, NULL, NULL, &textureWidth, &textureHeight);
+	}
+
+	float centerX = GRID_OFFSET_X + col * CELL_SIZE + CELL_SIZE / 2.0f;
+	float centerY = GRID_OFFSET_Y + row * CELL_SIZE + CELL_SIZE / 2.0f;
+	float halfHeight = (CELL_SIZE - PIECE_MARGIN) / 2.0f;
+	float halfWidth = halfHeight * squash;
+
+	float u0 = static_cast<float>(source.x) / textureWidth;
+	float v0 = static_cast<float>(source.y) / textureHeight;
+	float u1 = static_cast<float>(source.x + source.w) / textureWidth;
+	float v1 = static_cast<float>(source.y + source.h) / textureHeight;
+
+	const SDL_Color white = { 255, 255, 255, 255 };
+	SDL_Vertex* quad = &vertices[count * 4];
+	quad[0] = { { centerX - halfWidth, centerY - halfHeight }, white, { u0, v0 } };
+	quad[1] = { { centerX + halfWidth, centerY - halfHeight }, white, { u1, v0 } };
+	quad[2] = { { centerX + halfWidth, centerY + halfHeight }, white, { u1, v1 } };
+	quad[3] = { { centerX - halfWidth, centerY + halfHeight }, white, { u0, v1 } };
+	count++;
+}
+
+void PieceBatch::Draw(SDL_Renderer* renderer) {
+	if (count == 0 || !texture) return;
+	SDL_RenderGeometry(renderer, texture, vertices.data(), count * 4, indices.data(), count * 6);
+	Profiler::CountDrawCall();
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <SDL.h>
+#include <vector>
+#include "Main.h"
+
+#define PIECE_BATCH_CAPACITY    (VARIANT_MAX_SIZE * VARIANT_MAX_SIZE)
+#define FLIP_SQUASH_STEPS       64      // Precomputed widths of a flipping disc
+
+// Collects every disc of the frame into one vertex buffer and draws them with a single
+// SDL_RenderGeometry call. The buffers are sized once for a full board and reused.
+class PieceBatch {
+public:
+	PieceBatch();
+
+	void Begin();
+
+	// squash is the disc width scale, 1 = flat on the board
+	void Add(int row, int col, char piece, float squash = 1.0f);
+	void Draw(SDL_Renderer* renderer);
+
+	// Width scale of a disc turned over by progress (0-1) of the flip, |cos(progress * PI)|
+	static float FlipSquash(float progress);
+
+private:
+	std::vector<SDL_Vertex> vertices;
+	std::vector<int> indices;       // Same two triangles for every quad, built once
+	SDL_Texture* texture = nullptr;
+	int textureWidth = 0;
+	int textureHeight = 0;
+	int count = 0;
+};
@@ -0,0 +1,229 @@
+#include "Profiler.h"
+#include "Main.h"
+#include "TextCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#define PROFILE_PHASES     static_cast<int>(ProfilePhase::PHASE_COUNT)
+
+static const char* PHASE_NAMES[PROFILE_PHASES] = { "events", "update", "ai", "render", "text", "present" };
+
+Uint64 Profiler::phaseTicks[PROFILE_PHASES] = {};
+std::vector<ProfilePhase> Profiler::stack;
+Uint64 Profiler::segmentStart = 0;
+int Profiler::drawCalls = 0;
+int Profiler::texturesCreated = 0;
+
+Profiler::Sample Profiler::history[PROFILER_HISTORY];
+int Profiler::historyCount = 0;
+int Profiler::historyNext = 0;
+
+bool Profiler::overlayVisible = false;
+Uint32 Profiler::lastTextRefresh = 0;
+std::vector<std::string> Profiler::overlayLines;
+
+std::string Profiler::csvPath;
+std::vector<Profiler::Sample> Profiler::csvSamples;
+
+float Profiler::ToMs(Uint64 ticks) {
+	static const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+	return static_cast<float>(ticks * 1000.0 / frequency);
+}
+
+void Profiler::Begin(ProfilePhase phase) {
+	// The running phase is paused while the nested one runs
+	Uint64 now = SDL_GetPerformanceCounter();
+	if (!stack.empty()) {
+		phaseTicks[static_cast<int>(stack.back())] += now - segmentStart;
+	}
+	stack.push_back(phase);
+	segmentStart = now;
+}
+
+void Profiler::End() {
+	if (stack.empty()) return;
+
+	Uint64 now = SDL_GetPerformanceCounter();
+	phaseTicks[static_cast<int>(stack.back())] += now - segmentStart;
+	stack.pop_back();
+	segmentStart = now;
+}
+
+void Profiler::CountDrawCall(int calls) {
+	drawCalls += calls;
+}
+
+void Profiler::CountTextureCreated() {
+	texturesCreated++;
+}
+
+void Profiler::EndFrame() {
+	Sample& sample = history[historyNext];
+	sample.time = SDL_GetTicks();
+	sample.frameMs = 0.0f;
+	for (int phase = 0; phase < PROFILE_PHASES; phase++) {
+		sample.phaseMs[phase] = ToMs(phaseTicks[phase]);
+		sample.frameMs += sample.phaseMs[phase];
+		phaseTicks[phase] = 0;
+	}
+	sample.drawCalls = drawCalls;
+	sample.texturesCreated = texturesCreated;
+	drawCalls = 0;
+	texturesCreated = 0;
+
+	if (!csvPath.empty()) csvSamples.push_back(sample);
+
+	historyNext = (historyNext + 1) % PROFILER_HISTORY;
+	historyCount = std::min(historyCount + 1, PROFILER_HISTORY);
+}
+
+void Profiler::ToggleOverlay() {
+	overlayVisible = !overlayVisible;
+	lastTextRefresh = 0;
+}
+
+bool Profiler::IsOverlayVisible() {
+	return overlayVisible;
+}
+
+float Profiler::Percentile99() {
+	if (historyCount == 0) return 0.0f;
+
+	float frames[PROFILER_HISTORY];
+	for (int i = 0; i < historyCount; i++) {
+		frames[i] = history[i].frameMs;
+	}
+	int rank = (historyCount * 99 + 99) / 100 - 1;
+	std::nth_element(frames, frames + rank, frames + historyCount);
+	return frames[rank];
+}
+
+void Profiler::RefreshOverlayText() {
+	float phaseMs[PROFILE_PHASES] = {};
+	float frameMs = 0.0f;
+	float drawCallsAverage = 0.0f;
+	int texturesTotal = 0;
+	for (int i = 0; i < historyCount; i++) {
+		for (int phase = 0; phase < PROFILE_PHASES; phase++) {
+			phaseMs[phase] += history[i].phaseMs[phase];
+		}
+		frameMs += history[i].frameMs;
+		drawCallsAverage += history[i].drawCalls;
+		texturesTotal += history[i].texturesCreated;
+	}
+	float frames = static_cast<float>(std::max(historyCount, 1));
+
+	// Averages over the frames in the graph
+	char line[128];
+	overlayLines.clear();
+	sprintf_s(line, "frame %.2f ms  p99 %.2f ms  (%d frames)", frameMs / frames, Percentile99(), historyCount);
+	overlayLines.push_back(line);
+	for (int phase = 0; phase < PROFILE_PHASES; phase += 2) {
+		sprintf_s(line, "%-8s %6.3f ms   %-8s %6.3f ms", PHASE_NAMES[phase], phaseMs[phase] / frames,
+			PHASE_NAMES[phase + 1], phaseMs[phase + 1] / frames);
+		overlayLines.push_back(line);
+	}
+	sprintf_s(line, "draw calls %.1f/frame  textures %d", drawCallsAverage / frames, texturesTotal);
+	overlayLines.push_back(line);
+}
+
+void Profiler::DrawOverlay(SDL_Renderer* renderer) {
+	if (!overlayVisible) return;
+
+	// The overlay is not part of the measured frame
+	Uint64 savedTicks[PROFILE_PHASES];
+	std::memcpy(savedTicks, phaseTicks, sizeof(phaseTicks));
+	int savedDrawCalls = drawCalls;
+	int savedTextures = texturesCreated;
+
+	Uint32 now = SDL_GetTicks();
+	if (overlayLines.empty() || now - lastTextRefresh >= PROFILER_TEXT_REFRESH_MS) {
+		RefreshOverlayText();
+		lastTextRefresh = now;
+	}
+
+	const int padding = 6;
+	const int lineHeight = PROFILER_TEXT_SIZE + 4;
+	const int width = PROFILER_HISTORY + 2 * padding;
+	const int height = static_cast<int>(overlayLines.size()) * lineHeight + PROFILER_GRAPH_HEIGHT + 3 * padding;
+	const int left = WINDOW_WIDTH - width - padding;
+	const int top = padding;
+
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 200);
+	SDL_Rect panel = { left, top, width, height };
+	SDL_RenderFillRect(renderer, &panel);
+
+	int y = top + padding;
+	for (const std::string& line : overlayLines) {
+		TextCache::Draw(renderer, line.c_str(), left + padding, y, PROFILER_TEXT_SIZE, { 255, 255, 255, 255 });
+		y += lineHeight;
+	}
+
+	// Frame time graph, oldest frame on the left, frames over the 60 Hz budget in red
+	int graphBottom = top + height - padding;
+	SDL_Rect fastBars[PROFILER_HISTORY];
+	SDL_Rect slowBars[PROFILER_HISTORY];
+	int fastCount = 0;
+	int slowCount = 0;
+	for (int i = 0; i < historyCount; i++) {
+		const Sample& sample = history[(historyNext - historyCount + i + PROFILER_HISTORY) % PROFILER_HISTORY];
+		int barHeight = static_cast<int>(std::min(sample.frameMs / PROFILER_GRAPH_MAX_MS, 1.0f) * PROFILER_GRAPH_HEIGHT);
+		SDL_Rect bar = { left + padding + PROFILER_HISTORY - historyCount + i, graphBottom - std::max(barHeight, 1), 1, std::max(barHeight, 1) };
+		if (sample.frameMs > 1000.0f / 60.0f) {
+			slowBars[slowCount++] = bar;
+		}
+		else {
+			fastBars[fastCount++] = bar;
+		}
+	}
+	SDL_SetRenderDrawColor(renderer, 80, 220, 80, 255);
+	SDL_RenderFillRects(renderer, fastBars, fastCount);
+	SDL_SetRenderDrawColor(renderer, 230, 60, 60, 255);
+	SDL_RenderFillRects(renderer, slowBars, slowCount);
+
+	// 16.7 ms line
+	int budgetY = graphBottom - static_cast<int>((1000.0f / 60.0f) / PROFILER_GRAPH_MAX_MS * PROFILER_GRAPH_HEIGHT);
+	SDL_SetRenderDrawColor(renderer, 255, 255, 255, 120);
+	SDL_RenderDrawLine(renderer, left + padding, budgetY, left + padding + PROFILER_HISTORY, budgetY);
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+
+	std::memcpy(phaseTicks, savedTicks, sizeof(phaseTicks));
+	drawCalls = savedDrawCalls;
+	texturesCreated = savedTextures;
+}
+
+void Profiler::EnableCsv(const char* path) {
+	csvPath = path;
+	csvSamples.reserve(60 * 60 * 10);
+}
+
+void Profiler::Shutdown() {
+	if (csvPath.empty()) return;
+
+	std::ofstream file(csvPath);
+	if (!file) {
+		std::cerr << "Failed to write profile: " << csvPath << std::endl;
+		return;
+	}
+
+	file << "frame,time_ms";
+	for (int phase = 0; phase < PROFILE_PHASES; phase++) {
+		file << ',' << PHASE_NAMES[phase] << "_ms";
+	}
+	file << ",frame_ms,draw_calls,textures_created\n";
+
+	for (size_t i = 0; i < csvSamples.size(); i++) {
+		const Sample& sample = csvSamples[i];
+		file << i << ',' << sample.time;
+		for (int phase = 0; phase < PROFILE_PHASES; phase++) {
+			file << ',' << sample.phaseMs[phase];
+		}
+		file << ',' << sample.frameMs << ',' << sample.drawCalls << ',' << sample.texturesCreated << '\n';
+	}
+	std::cout << "Profile written to " << csvPath << " (" << csvSamples.size() << " frames)" << std::endl;
+	csvSamples.clear();
+}
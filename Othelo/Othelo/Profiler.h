@@ -0,0 +1,84 @@
+#pragma once
+#include <SDL.h>
+#include <string>
+#include <vector>
+
+#define PROFILER_HISTORY        240     // Frames kept for the graph and the percentile
+#define PROFILER_TEXT_REFRESH_MS 500    // Overlay numbers change twice a second, so they stay readable
+#define PROFILER_TEXT_SIZE      14
+#define PROFILER_GRAPH_HEIGHT   60
+#define PROFILER_GRAPH_MAX_MS   33.3f   // Top of the graph (two frames at 60 Hz)
+#define PROFILER_TOGGLE_KEY     SDLK_F3
+
+enum class ProfilePhase {
+	EVENTS,         // Event polling and input handling
+	UPDATE,         // UpdateGameState, animations and game over logic
+	AI,             // Starting and polling the AI search (the search itself runs on other threads)
+	RENDER,         // Building the frame
+	TEXT,           // Text cache lookups and rasterization
+	PRESENT,        // SDL_RenderPresent
+	PHASE_COUNT
+};
+
+// Frame profiler: phase timings with SDL_GetPerformanceCounter, draw call and texture counters.
+// Phases nest (text inside render) and each one only keeps its own time, so a frame's
+// phases add up to the frame time. Time spent waiting for events is not part of a frame.
+class Profiler {
+public:
+	struct Sample {
+		Uint32 time;                    // SDL_GetTicks when the frame was presented
+		float phaseMs[static_cast<int>(ProfilePhase::PHASE_COUNT)];
+		float frameMs;
+		int drawCalls;
+		int texturesCreated;
+	};
+
+	static void Begin(ProfilePhase phase);
+	static void End();
+
+	static void CountDrawCall(int calls = 1);
+	static void CountTextureCreated();
+
+	// Closes the frame, loop iterations that draw nothing are added to the next frame
+	static void EndFrame();
+
+	static void ToggleOverlay();
+	static bool IsOverlayVisible();
+	static void DrawOverlay(SDL_Renderer* renderer);
+
+	// Keeps every frame and writes them to path at Shutdown
+	static void EnableCsv(const char* path);
+	static void Shutdown();
+
+private:
+	static float ToMs(Uint64 ticks);
+	static float Percentile99();
+	static void RefreshOverlayText();
+
+	static Uint64 phaseTicks[static_cast<int>(ProfilePhase::PHASE_COUNT)];
+	static std::vector<ProfilePhase> stack;
+	static Uint64 segmentStart;
+	static int drawCalls;
+	static int texturesCreated;
+
+	static Sample history[PROFILER_HISTORY];
+	static int historyCount;
+	static int historyNext;
+
+	static bool overlayVisible;
+	static Uint32 lastTextRefresh;
+	static std::vector<std::string> overlayLines;
+
+	static std::string csvPath;
+	static std::vector<Sample> csvSamples;
+};
+
+// Times the enclosing block as one phase
+class ProfileScope {
+public:
+	explicit ProfileScope(ProfilePhase phase) { Profiler::Begin(phase); }
+	~ProfileScope() { Profiler::End(); }
+
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope& operator=(const ProfileScope&) = delete;
+};
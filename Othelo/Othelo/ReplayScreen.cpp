@@ -0,0 +1,136 @@
+#include "ReplayScreen.h"
+#include "GameRecord.h"
+#include "BoardLayer.h"
+#include "PieceBatch.h"
+#include "HintSprites.h"
+#include "Profiler.h"
+#include "Sound.h"
+
+static GameReplay replay;
+static PieceBatch replayPieces;
+static bool scrubbing = false;          // Mouse button held on the progress bar
+
+bool OpenReplay(const char* path) {
+	GameRecord record;
+	if (!record.Load(path) || !replay.Load(record)) return false;
+
+	scrubbing = false;
+	return true;
+}
+
+// Progress bar under the board
+static SDL_Rect GetProgressBarRect() {
+	return { GRID_OFFSET_X, GRID_OFFSET_Y + GRID_HEIGHT + REPLAY_BAR_HEIGHT, GRID_WIDTH, REPLAY_BAR_HEIGHT };
+}
+
+static void SeekToMouse(int mouseX) {
+	SDL_Rect bar = GetProgressBarRect();
+	float position = static_cast<float>(mouseX - bar.x) / bar.w;
+	replay.Seek(static_cast<int>(position * replay.GetLength() + 0.5f));
+	RequestRedraw();
+}
+
+void RenderReplayScreen(SDL_Renderer* renderer, Language currentLanguage) {
+	BoardLayer::Draw(renderer);
+
+	// Discs of the current ply, no flip animation when seeking
+	const Board& board = replay.GetBoard();
+	replayPieces.Begin();
+	Bitboard occupied = board.black | board.white;
+	while (occupied) {
+		int square = PopLowestBit(occupied);
+		replayPieces.Add(square / GRID_SIZE, square % GRID_SIZE, ((board.black >> square) & 1) ? 'B' : 'W');
+	}
+	replayPieces.Draw(renderer);
+
+	int lastMove = replay.GetLastMove();
+	if (lastMove >= 0) {
+		HintSprites::Begin();
+		HintSprites::Add(lastMove / GRID_SIZE, lastMove % GRID_SIZE, HintKind::DOT, { LAST_MOVE_COLOR });
+		HintSprites::Draw(renderer);
+	}
+
+	const GameStrings& strings = GetGameStrings(currentLanguage);
+	char text[100];
+	sprintf_s(text, strings.scoreText, board.CountPieces('B'), board.CountPieces('W'));
+	RenderTextWithSize(renderer, text, GetRelativeX(0.02f), GetRelativeY(0.02f), TEXT_SIZE);
+
+	sprintf_s(text, strings.replayMoveText, replay.GetPly(), replay.GetLength());
+	RenderTextWithSize(renderer, text, GetRelativeX(0.45f), GetRelativeY(0.02f), TEXT_SIZE);
+
+	RenderTextWithSize(renderer, strings.replayHelpMessage, GetRelativeX(0.02f), GetRelativeY(0.92f), TEXT_SIZE);
+
+	SDL_Rect bar = GetProgressBarRect();
+	SDL_SetRenderDrawColor(renderer, REPLAY_BAR_COLOR);
+	SDL_RenderFillRect(renderer, &bar);
+	if (replay.GetLength() > 0) {
+		bar.w = bar.w * replay.GetPly() / replay.GetLength();
+		SDL_SetRenderDrawColor(renderer, REPLAY_BAR_FILL_COLOR);
+		SDL_RenderFillRect(renderer, &bar);
+	}
+	Profiler::CountDrawCall(2);
+}
+
+void HandleReplayScreenEvents(SDL_Event& event, GameState& currentState, bool& quit, SDL_Window* window) {
+	while (SDL_PollEvent(&event)) {
+		if (event.type != SDL_MOUSEMOTION) {
+			RequestRedraw();
+		}
+
+		if (event.type == SDL_QUIT) {
+			quit = true;
+		}
+		else if (event.type == SDL_WINDOWEVENT) {
+			HandleWindowEvent(event, window);
+		}
+		else if (event.type == SDL_RENDER_TARGETS_RESET) {
+			BoardLayer::Rebuild(SDL_GetRenderer(window));
+		}
+		else if (event.type == SDL_KEYDOWN) {
+			switch (event.key.keysym.sym) {
+			case SDLK_LEFT:
+				replay.Seek(replay.GetPly() - 1);
+				break;
+			case SDLK_RIGHT:
+				replay.Seek(replay.GetPly() + 1);
+				break;
+			case SDLK_PAGEUP:
+				replay.Seek(replay.GetPly() - REPLAY_PAGE_PLIES);
+				break;
+			case SDLK_PAGEDOWN:
+				replay.Seek(replay.GetPly() + REPLAY_PAGE_PLIES);
+				break;
+			case SDLK_HOME:
+				replay.Seek(0);
+				break;
+			case SDLK_END:
+				replay.Seek(replay.GetLength());
+				break;
+			case PROFILER_TOGGLE_KEY:
+				Profiler::ToggleOverlay();
+				break;
+			case SDLK_t:
+			case SDLK_ESCAPE:
+				SoundSystem::PlaySound(SoundSystem::MENU_SELECT);
+				currentState = GameState::TITLE_SCREEN;
+				break;
+			}
+		}
+		else if (event.type == SDL_MOUSEBUTTONDOWN && event.button.button == SDL_BUTTON_LEFT) {
+			SDL_Point point = { event.button.x, event.button.y };
+			SDL_Rect bar = GetProgressBarRect();
+			bar.y -= REPLAY_BAR_HEIGHT / 2;     // Easier to hit
+			bar.h += REPLAY_BAR_HEIGHT;
+			if (SDL_PointInRect(&point, &bar)) {
+				scrubbing = true;
+				SeekToMouse(point.x);
+			}
+		}
+		else if (event.type == SDL_MOUSEMOTION && scrubbing) {
+			SeekToMouse(event.motion.x);
+		}
+		else if (event.type == SDL_MOUSEBUTTONUP && event.button.button == SDL_BUTTON_LEFT) {
+			scrubbing = false;
+		}
+	}
+}
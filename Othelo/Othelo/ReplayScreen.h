@@ -0,0 +1,15 @@
+#pragma once
+#include <SDL.h>
+#include "Title.h" // For GameState and Language
+
+#define REPLAY_PAGE_PLIES       10      // PageUp/PageDown step
+#define REPLAY_BAR_HEIGHT       10
+#define REPLAY_BAR_COLOR        0, 60, 0, 255
+#define REPLAY_BAR_FILL_COLOR   255, 255, 255, 255
+#define LAST_MOVE_COLOR         220, 40, 40, 255
+
+// Replay viewer for a saved game record. Seeking rebuilds the position from the record's
+// snapshots, so stepping and scrubbing are instant and nothing is animated.
+bool OpenReplay(const char* path);
+void RenderReplayScreen(SDL_Renderer* renderer, Language currentLanguage);
+void HandleReplayScreenEvents(SDL_Event& event, GameState& currentState, bool& quit, SDL_Window* window);
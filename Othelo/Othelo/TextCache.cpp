@@ -0,0 +1,99 @@
+#include "TextCache.h"
+#include "Main.h"
+#include "Profiler.h"
+#include <iostream>
+
+std::map<int, TTF_Font*> TextCache::fonts;
+std::list<TextCache::Entry> TextCache::entries;
+std::unordered_map<std::string, std::list<TextCache::Entry>::iterator> TextCache::index;
+
+TTF_Font* TextCache::GetFont(int fontSize) {
+	auto it = fonts.find(fontSize);
+	if (it != fonts.end()) return it->second;
+
+	// Sizes follow the window height, so old sizes pile up after a few resizes
+	if (fonts.size() >= TEXT_CACHE_MAX_FONTS) {
+		for (auto& font : fonts) {
+			TTF_CloseFont(font.second);
+		}
+		fonts.clear();
+	}
+
+	TTF_Font* font = TTF_OpenFont(TEXT_FONT, fontSize);
+	if (!font) {
+		std::cerr << "Failed to load font with size " << fontSize << ": " << TTF_GetError() << std::endl;
+		return nullptr;
+	}
+	fonts[fontSize] = font;
+	return font;
+}
+
+TextCache::Text TextCache::Get(SDL_Renderer* renderer, const char* text, int fontSize, SDL_Color color) {
+	ProfileScope scope(ProfilePhase::TEXT);
+
+	std::string key = text;
+	key += '\0';
+	key += std::to_string(fontSize) + ':' + std::to_string(color.r) + ',' + std::to_string(color.g) + ','
+		+ std::to_string(color.b) + ',' + std::to_string(color.a);
+
+	auto found = index.find(key);
+	if (found != index.end()) {
+		entries.splice(entries.begin(), entries, found->second);
+		return found->second->text;
+	}
+
+	Text result = { nullptr, 0, 0 };
+	TTF_Font* font = GetFont(fontSize);
+	if (!font) return result;
+
+	SDL_Surface* surface = TTF_RenderUTF8_Blended(font, text, color);
+	if (!surface) {
+		std::cerr << "Failed to render text: " << TTF_GetError() << std::endl;
+		return result;
+	}
+
+	result.texture = SDL_CreateTextureFromSurface(renderer, surface);
+	Profiler::CountTextureCreated();
+	result.width = surface->w;
+	result.height = surface->h;
+	SDL_FreeSurface(surface);
+	if (!result.texture) {
+		std::cerr << "Failed to create texture: " << SDL_GetError() << std::endl;
+		return result;
+	}
+
+	// Least recently used strings go first (countdowns and old scores)
+	if (entries.size() >= TEXT_CACHE_CAPACITY) {
+		SDL_DestroyTexture(entries.back().text.texture);
+		index.erase(entries.back().key);
+		entries.pop_back();
+	}
+	entries.push_front({ key, result });
+	index[key] = entries.begin();
+	return result;
+}
+
+void TextCache::Draw(SDL_Renderer* renderer, const char* text, int x, int y, int fontSize, SDL_Color color) {
+	Text cached = Get(renderer, text, fontSize, color);
+	if (!cached.texture) return;
+
+	SDL_Rect rect = { x, y, cached.width, cached.height };
+	SDL_RenderCopy(renderer, cached.texture, NULL, &rect);
+	Profiler::CountDrawCall();
+}
+
+void TextCache::Invalidate() {
+	for (auto& entry : entries) {
+		SDL_DestroyTexture(entry.text.texture);
+	}
+	entries.clear();
+	index.clear();
+}
+
+void TextCache::Shutdown() {
+	Invalidate();
+	for (auto& font : fonts) {
+		TTF_CloseFont(font.second);
+	}
+	fonts.clear();
+}
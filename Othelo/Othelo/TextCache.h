@@ -0,0 +1,41 @@
+#pragma once
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+#define TEXT_CACHE_CAPACITY     64      // Rendered strings kept as textures
+#define TEXT_CACHE_MAX_FONTS    8       // Font sizes kept open
+
+// Rendered text cache: fonts stay open per pixel size and every (string, size, color)
+// is rasterized once into a texture, so drawing text is a single SDL_RenderCopy.
+class TextCache {
+public:
+	struct Text {
+		SDL_Texture* texture;
+		int width;
+		int height;
+	};
+
+	// Returns the texture of the string (texture is null if the font or the rendering failed)
+	static Text Get(SDL_Renderer* renderer, const char* text, int fontSize, SDL_Color color);
+	static void Draw(SDL_Renderer* renderer, const char* text, int x, int y, int fontSize, SDL_Color color);
+
+	// Drops the textures (window resize, language change), fonts stay open
+	static void Invalidate();
+	static void Shutdown();
+
+private:
+	struct Entry {
+		std::string key;
+		Text text;
+	};
+
+	static TTF_Font* GetFont(int fontSize);
+
+	static std::map<int, TTF_Font*> fonts;
+	static std::list<Entry> entries;        // Most recently used first
+	static std::unordered_map<std::string, std::list<Entry>::iterator> index;
+};
@@ -1,38 +1,25 @@
 ﻿#include "Title.h"
 #include "Main.h"
 #include "Sound.h"
+#include "TextCache.h"
+#include "BoardLayer.h"
+#include "Profiler.h"
+#include "ReplayScreen.h"
 #include <SDL.h>
 #include <SDL_ttf.h>
-// Overloaded version that accepts a custom font size
+// Text is drawn from the cache: no font loading or rasterizing after the first frame
 void RenderTextWithSize(SDL_Renderer* renderer, const char* text, int x, int y, int fontSize) {
-    TTF_Font* customFont = TTF_OpenFont(TEXT_FONT, fontSize);
-    if (!customFont) {
-        std::cerr << "Failed to load font with size " << fontSize << ": " << TTF_GetError() << std::endl;
-        return;
-    }
-
-    SDL_Color color = { TEXT_COLOR };
-    SDL_Surface* surface = TTF_RenderUTF8_Blended(customFont, text, color);
-    if (!surface) {
-        std::cerr << "Failed to render text: " << TTF_GetError() << std::endl;
-        TTF_CloseFont(customFont);
-        return;
-    }
-
-    SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
-    if (!texture) {
-        std::cerr << "Failed to create texture: " << SDL_GetError() << std::endl;
-        SDL_FreeSurface(surface);
-        TTF_CloseFont(customFont);
-        return;
-    }
+    TextCache::Draw(renderer, text, x, y, fontSize, { TEXT_COLOR });
+}
 
-    SDL_Rect rect = { x, y, surface->w, surface->h };
-    SDL_RenderCopy(renderer, texture, NULL, &rect);
+// Draws text horizontally centered on centerX
+static void RenderCenteredText(SDL_Renderer* renderer, const char* text, int centerX, int y, int fontSize) {
+    TextCache::Text cached = TextCache::Get(renderer, text, fontSize, { TEXT_COLOR });
+    if (!cached.texture) return;
 
-    SDL_FreeSurface(surface);
-    SDL_DestroyTexture(texture);
-    TTF_CloseFont(customFont);
+    SDL_Rect rect = { centerX - cached.width / 2, y, cached.width, cached.height };
+    SDL_RenderCopy(renderer, cached.texture, NULL, &rect);
+    Profiler::CountDrawCall();
 }
 
 void RenderTitlePieces(SDL_Renderer* renderer, SDL_Texture* pieceTexture, Uint32 currentTime) {
@@ -61,6 +48,7 @@ void RenderTitlePieces(SDL_Renderer* renderer, SDL_Texture* pieceTexture, Uint32
             pieceSize
         };
         SDL_RenderCopy(renderer, pieceTexture, &blackPieceRect, &leftDst);
+        Profiler::CountDrawCall();
     }
 
     // Middle white piece (appears in step 2, animates in step 4)
@@ -72,6 +60,7 @@ void RenderTitlePieces(SDL_Renderer* renderer, SDL_Texture* pieceTexture, Uint32
             pieceSize
         };
         SDL_RenderCopy(renderer, pieceTexture, &whitePieceRect, &middleDst);
+        Profiler::CountDrawCall();
 
         if (animationStep == 4) {
             Uint32 stepTime = currentTime % TITLE_ANIMATION_STEP_DURATION;
@@ -81,6 +70,7 @@ void RenderTitlePieces(SDL_Renderer* renderer, SDL_Texture* pieceTexture, Uint32
             SDL_Point center = { pieceSize / 2, pieceSize / 2 };
             SDL_RenderCopyEx(renderer, pieceTexture, &blackPieceRect, &middleDst,
                 (rotationAngle - M_PI / 2) * 180.0f / M_PI, &center, SDL_FLIP_NONE);
+            Profiler::CountDrawCall();
         }
     }
 
@@ -93,13 +83,15 @@ void RenderTitlePieces(SDL_Renderer* renderer, SDL_Texture* pieceTexture, Uint32
             pieceSize
         };
         SDL_RenderCopy(renderer, pieceTexture, &blackPieceRect, &rightDst);
+        Profiler::CountDrawCall();
     }
 }
 
-void RenderTitleScreen(SDL_Renderer* renderer, TTF_Font* font, Language currentLanguage, Uint32 currentTime, SDL_Texture* pieceTexture) {
+void RenderTitleScreen(SDL_Renderer* renderer, Language currentLanguage, Uint32 currentTime, SDL_Texture* pieceTexture) {
     // Clear screen with a dark background
     SDL_SetRenderDrawColor(renderer, 0, 50, 0, 255);
     SDL_RenderClear(renderer);
+    Profiler::CountDrawCall();
 
     // Render pieces animation
     RenderTitlePieces(renderer, pieceTexture, currentTime);
@@ -113,124 +105,57 @@ void RenderTitleScreen(SDL_Renderer* renderer, TTF_Font* font, Language currentL
 
     // Render game title with dynamic font size
     int titleFontSize = GetTitleFontSize()*2;
-    TTF_Font* titleFont = TTF_OpenFont(TEXT_FONT, titleFontSize);
-    if (titleFont) {
-        SDL_Surface* titleSurface = TTF_RenderUTF8_Blended(titleFont, gameStrings.windowName, { TEXT_COLOR });
-        if (titleSurface) {
-            SDL_Texture* titleTexture = SDL_CreateTextureFromSurface(renderer, titleSurface);
-            if (titleTexture) {
-                SDL_Rect titleRect = {
-                    centerX - titleSurface->w / 2,
-                    static_cast<int>(centerY - WINDOW_HEIGHT * 0.35f),
-                    titleSurface->w,
-                    titleSurface->h
-                };
-                SDL_RenderCopy(renderer, titleTexture, NULL, &titleRect);
-                SDL_DestroyTexture(titleTexture);
-            }
-            SDL_FreeSurface(titleSurface);
-        }
-        TTF_CloseFont(titleFont);
-    }
+    RenderCenteredText(renderer, gameStrings.windowName, centerX, static_cast<int>(centerY - WINDOW_HEIGHT * 0.35f), titleFontSize);
 
-    // Create font for regular text with dynamic size
+    // Regular text with dynamic size
     int regularFontSize = GetRegularFontSize();
-    TTF_Font* regularFont = TTF_OpenFont(TEXT_FONT, regularFontSize);
-    if (!regularFont) {
-        regularFont = font; // Fallback to the provided font
-    }
 
     // Blinking "Press to Start" message
     bool showText = (currentTime / BLINK_INTERVAL_MS) % 2 == 0;
     if (showText) {
-        SDL_Surface* startSurface = TTF_RenderUTF8_Blended(regularFont, titleStrings.pressToStart, { TEXT_COLOR });
-        if (startSurface) {
-            SDL_Texture* startTexture = SDL_CreateTextureFromSurface(renderer, startSurface);
-            if (startTexture) {
-                SDL_Rect startRect = {
-                    centerX - startSurface->w / 2,
-                    static_cast<int>(centerY + WINDOW_HEIGHT * 0.10f),
-                    startSurface->w,
-                    startSurface->h
-                };
-                SDL_RenderCopy(renderer, startTexture, NULL, &startRect);
-                SDL_DestroyTexture(startTexture);
-            }
-            SDL_FreeSurface(startSurface);
-        }
+        RenderCenteredText(renderer, titleStrings.pressToStart, centerX, static_cast<int>(centerY + WINDOW_HEIGHT * 0.10f), regularFontSize);
     }
 
     // Render game mode selection
     const char* modeText = (currentGameMode == GameMode::TwoPlayers) ?
         titleStrings.twoPlayersMode : titleStrings.vsAIMode;
-    SDL_Surface* modeSurface = TTF_RenderUTF8_Blended(regularFont, modeText, { TEXT_COLOR });
-    if (modeSurface) {
-        SDL_Texture* modeTexture = SDL_CreateTextureFromSurface(renderer, modeSurface);
-        if (modeTexture) {
-            SDL_Rect modeRect = {
-                centerX - modeSurface->w / 2,
-                static_cast<int>(centerY + WINDOW_HEIGHT * 0.18f),
-                modeSurface->w,
-                modeSurface->h
-            };
-            SDL_RenderCopy(renderer, modeTexture, NULL, &modeRect);
-            SDL_DestroyTexture(modeTexture);
-        }
-        SDL_FreeSurface(modeSurface);
-    }
+    RenderCenteredText(renderer, modeText, centerX, static_cast<int>(centerY + WINDOW_HEIGHT * 0.16f), regularFontSize);
 
-    // Render language selection
-    SDL_Surface* langSurface = TTF_RenderUTF8_Blended(regularFont, titleStrings.languageOption, { TEXT_COLOR });
-    if (langSurface) {
-        SDL_Texture* langTexture = SDL_CreateTextureFromSurface(renderer, langSurface);
-        if (langTexture) {
-            SDL_Rect langRect = {
-                centerX - langSurface->w / 2,
-                static_cast<int>(centerY + WINDOW_HEIGHT * 0.26f),
-                langSurface->w,
-                langSurface->h
-            };
-            SDL_RenderCopy(renderer, langTexture, NULL, &langRect);
-            SDL_DestroyTexture(langTexture);
-        }
-        SDL_FreeSurface(langSurface);
-    }
+    // Render AI level selection
+    char levelText[100];
+    sprintf_s(levelText, titleStrings.aiLevelOption,
+        titleStrings.aiLevelNames[static_cast<int>(currentAIDifficulty)]);
+    RenderCenteredText(renderer, levelText, centerX, static_cast<int>(centerY + WINDOW_HEIGHT * 0.22f), regularFontSize);
 
-    // Render quit instruction
-    SDL_Surface* quitSurface = TTF_RenderUTF8_Blended(regularFont, titleStrings.pressToQuit, { TEXT_COLOR });
-    if (quitSurface) {
-        SDL_Texture* quitTexture = SDL_CreateTextureFromSurface(renderer, quitSurface);
-        if (quitTexture) {
-            SDL_Rect quitRect = {
-                centerX - quitSurface->w / 2,
-                static_cast<int>(centerY + WINDOW_HEIGHT * 0.34f),
-                quitSurface->w,
-                quitSurface->h
-            };
-            SDL_RenderCopy(renderer, quitTexture, NULL, &quitRect);
-            SDL_DestroyTexture(quitTexture);
-        }
-        SDL_FreeSurface(quitSurface);
-    }
+    // Render board size selection
+    char sizeText[100];
+    sprintf_s(sizeText, titleStrings.boardSizeOption, GRID_SIZE, GRID_SIZE);
+    RenderCenteredText(renderer, sizeText, centerX, static_cast<int>(centerY + WINDOW_HEIGHT * 0.28f), regularFontSize);
 
-    // Clean up dynamic font if it was created
-    if (regularFont != font) {
-        TTF_CloseFont(regularFont);
-    }
+    // Render language selection
+    RenderCenteredText(renderer, titleStrings.languageOption, centerX, static_cast<int>(centerY + WINDOW_HEIGHT * 0.34f), regularFontSize);
+
+    // Render replay option
+    RenderCenteredText(renderer, titleStrings.replayOption, centerX, static_cast<int>(centerY + WINDOW_HEIGHT * 0.40f), regularFontSize);
 
-    SDL_RenderPresent(renderer);
+    // Render quit instruction
+    RenderCenteredText(renderer, titleStrings.pressToQuit, centerX, static_cast<int>(centerY + WINDOW_HEIGHT * 0.46f), regularFontSize);
 }
 
 void HandleTitleScreenEvents(SDL_Event& event, GameState& currentState, bool& quit, Language& currentLanguage, SDL_Window* window) {
     while (SDL_PollEvent(&event)) {
+        if (event.type != SDL_MOUSEMOTION) {
+            RequestRedraw();
+        }
+
         if (event.type == SDL_QUIT) {
             quit = true;
         }
         else if (event.type == SDL_WINDOWEVENT) {
-            if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
-                HandleWindowResize(window);
-                SDL_RenderPresent(SDL_GetRenderer(window));
-            }
+            HandleWindowEvent(event, window);
+        }
+        else if (event.type == SDL_RENDER_TARGETS_RESET) {
+            BoardLayer::Rebuild(SDL_GetRenderer(window));
         }
         else if (event.type == SDL_KEYDOWN) {
             switch (event.key.keysym.sym) {
@@ -238,18 +163,51 @@ void HandleTitleScreenEvents(SDL_Event& event, GameState& currentState, bool& qu
                 SoundSystem::PlaySound(SoundSystem::MENU_SELECT);
                 currentState = GameState::GAME_SCREEN;
                 break;
+            case PROFILER_TOGGLE_KEY:
+                Profiler::ToggleOverlay();
+                break;
             case SDLK_l:
                 SoundSystem::PlaySound(SoundSystem::MENU_CHANGE);
                 // Cycle to next language
                 currentLanguage = static_cast<Language>(
                     (static_cast<int>(currentLanguage) + 1) % static_cast<int>(Language::LANGUAGE_COUNT)
                     );
+                TextCache::Invalidate(); // Strings of the old language are not drawn again
                 break;
             case SDLK_p:
                 SoundSystem::PlaySound(SoundSystem::MENU_CHANGE);
                 currentGameMode = (currentGameMode == GameMode::TwoPlayers) ?
                     GameMode::VsAI : GameMode::TwoPlayers;
                 break;
+            case SDLK_d:
+                SoundSystem::PlaySound(SoundSystem::MENU_CHANGE);
+                // Cycle to next AI level
+                currentAIDifficulty = static_cast<AIDifficulty>(
+                    (static_cast<int>(currentAIDifficulty) + 1) % static_cast<int>(AIDifficulty::DIFFICULTY_COUNT)
+                    );
+                break;
+            case SDLK_b: {
+                SoundSystem::PlaySound(SoundSystem::MENU_CHANGE);
+                // Cycle to next board size, the game restarts on the new board
+                const int sizes[] = VARIANT_SIZES;
+                int next = 0;
+                for (int i = 0; i < static_cast<int>(sizeof(sizes) / sizeof(sizes[0])); i++) {
+                    if (sizes[i] == GRID_SIZE) next = (i + 1) % static_cast<int>(sizeof(sizes) / sizeof(sizes[0]));
+                }
+                SetBoardSize(sizes[next], window);
+                break;
+            }
+            case SDLK_r:
+                if (OpenReplay(LAST_GAME_FILE)) {
+                    // Game records are standard board games
+                    SetBoardSize(BOARD_SIZE, window);
+                    SoundSystem::PlaySound(SoundSystem::MENU_SELECT);
+                    currentState = GameState::REPLAY_SCREEN;
+                }
+                else {
+                    SoundSystem::PlaySound(SoundSystem::INVALID_MOVE);
+                }
+                break;
             case SDLK_ESCAPE:
             case SDLK_q:
                 quit = true;
@@ -18,7 +18,8 @@
 // Screen state
 enum class GameState {
 	TITLE_SCREEN,
-	GAME_SCREEN
+	GAME_SCREEN,
+	REPLAY_SCREEN
 };
 
 // Extended GameStrings structure to include title screen strings
@@ -28,6 +29,10 @@ struct TitleStrings {
 	const char* pressToQuit;
 	const char* twoPlayersMode;
 	const char* vsAIMode;
+	const char* aiLevelOption;
+	const char* boardSizeOption;
+	const char* replayOption;
+	const char* aiLevelNames[static_cast<int>(AIDifficulty::DIFFICULTY_COUNT)];
 };
 
 // Language-specific title strings
@@ -36,7 +41,11 @@ static const TitleStrings ENGLISH_TITLE_STRINGS = {
 	"[L]Choose Language",
 	"[Q/ESC]Quit",
 	"[P]Game Mode: 2 Players",
-	"[P]Game Mode: Vs AI"     
+	"[P]Game Mode: Vs AI",
+	"[D]AI Level: %s",
+	"[B]Board Size: %dx%d",
+	"[R]Replay Last Game",
+	{ "Easy", "Medium", "Hard", "Expert" }
 };
 
 static const TitleStrings JAPANESE_TITLE_STRINGS = {
@@ -44,7 +53,11 @@ static const TitleStrings JAPANESE_TITLE_STRINGS = {
 	u8"[L]言語を変更",
 	u8"[Q/ESC]終了",
 	u8"[P]ゲームモード: 2人",
-	u8"[P]ゲームモード: VS AI"
+	u8"[P]ゲームモード: VS AI",
+	u8"[D]AIレベル: %s",
+	u8"[B]盤面サイズ: %dx%d",
+	u8"[R]前回のゲームを再生",
+	{ u8"かんたん", u8"ふつう", u8"むずかしい", u8"エキスパート" }
 };
 
 static const TitleStrings PORTUGUESE_TITLE_STRINGS = {
@@ -52,7 +65,11 @@ static const TitleStrings PORTUGUESE_TITLE_STRINGS = {
 	u8"[L]Mudar o Idioma",
 	u8"[Q/ESC]Sair",
 	u8"[P]Modo de Jogo: 2 Jogadores",
-	u8"[P]Modo de Jogo: Vs AI"
+	u8"[P]Modo de Jogo: Vs AI",
+	u8"[D]Nível da IA: %s",
+	u8"[B]Tamanho do Tabuleiro: %dx%d",
+	u8"[R]Rever Último Jogo",
+	{ u8"Fácil", u8"Médio", u8"Difícil", u8"Especialista" }
 };
 
 
@@ -90,5 +107,5 @@ inline int GetSmallFontSize() {
 
 // Shared rendering function declarations
 void RenderTextWithSize(SDL_Renderer* renderer, const char* text, int x, int y, int fontSize);
-void RenderTitleScreen(SDL_Renderer* renderer, TTF_Font* font, Language currentLanguage, Uint32 currentTime, SDL_Texture* pieceTexture);
+void RenderTitleScreen(SDL_Renderer* renderer, Language currentLanguage, Uint32 currentTime, SDL_Texture* pieceTexture);
 void HandleTitleScreenEvents(SDL_Event& event, GameState& currentState, bool& quit, Language& currentLanguage, SDL_Window* window);
\ No newline at end of file
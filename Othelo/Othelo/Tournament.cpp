@@ -0,0 +1,360 @@
+#include "Tournament.h"
+#include "Variant.h"
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+// Built-in start positions: random 8-ply openings that a depth 10 search scores close to even
+static const char* BALANCED_OPENINGS[] = {
+	"c4e3f4c3d2e1d6c5", "d3c3c4c5b6c6b3d2", "e6f4c3d6f5c4c7e7", "c4e3f4c5d2f2e2b3",
+	"f5d6c4g5g6e3d7c7", "c4e3f4g3f6b4e2e6", "f5f4g3c6d3f3d6c2", "d3e3f3c3c5e2f6e6",
+	"c4c5b6d3e6d6c6f6", "e6f4c3c6c4e7f7c5", "d3e3f5e6d7c6f4e7", "f5d6c7f6d3g5h5h4",
+	"d3c5d6e7f6f5d8f3", "d3c5d6c3f5f4f3d2", "d3c5c6e3b5a5f3e2", "d3c5b6d2e6f4g3e7",
+	"e6f4g3c6c4f3d6f6", "f5f4e3f2g3d6c4c5", "f5d6c6f4d3b6d7g5", "e6d6c5b6d3f5g6g5",
+	"f5f4e3d2c3c4d3c5", "c4c5f6d3c6d6e6f5", "d3c3e6d2c2d6d1f6", "f5d6c7f3d3c6e3d2",
+	"e6f4c3c4e3d6c6f7", "d3e3f4c5c6d6e6d7", "f5d6c6b6c3f3d7c4", "f5d6c7f3c3c4c5b6",
+	"f5f4d3c4b5d6e6c2", "f5f4e3d2g3f6f7d6", "d3c3f5f6f7c5e6f4", "d3c5d6c7d7e3b5d2",
+	"f5f4g3d6e3f3f2f6", "c4e3f5c6f4e6d3c5", "c4e3f6c6c5b6c7b4", "d3c5b6e3d6b5b4a7",
+	"c4e3f6c5d3b4f3e2", "c4c5f6b3d6f5b4f3", "c4c3e6f6c2e7d3c5", "c4c3c2f4d3b4f6c1",
+	"f5f4c3d6d7c6d3g5", "f5f6d3c5e6d6d7g5", "e6f6d3c3b3d2c2e3", "c4c5b6d3e3b5c6f5",
+	"d3c5e6e3f3f4d6e2", "f5f6f7e3f3d6e2f2", "d3c5e6e3e2f7d6f5", "e6f6c4c3d3d6f7e3",
+	"d3c5c6c7f5f3b5c4", "d3c3f5d2c2c1b1f6", "e6d6c4d3c5b6d2f4", "c4e3f3c5e6c3d3g3",
+	"d3c5b6c3e3e2f2c2", "c4c3c2e3f3g3f5d6", "d3c3b3c5c6f4b5a5", "c4c3e6f6g6e7d6d7",
+	"f5d6c6f6d7c5b4g5", "e6d6c4f4c6c3g3d7", "e6d6c6d7c7f6d3e3", "f5f6e6f4g4d6d7g6",
+	"c4e3f2c5f4e2f6g5", "d3e3f2c2f3f5f6e6", "c4c3d3e3f5d6c2b3", "d3c5b6f3f6c4d6c2"
+};
+
+static const char* LEVEL_NAMES[] = { "easy", "medium", "hard", "expert" };
+
+// Results from engine A's point of view
+struct MatchStats {
+	int wins = 0;
+	int draws = 0;
+	int losses = 0;
+
+	int Games() const { return wins + draws + losses; }
+	double Score() const { return Games() ? (wins + 0.5 * draws) / Games() : 0.5; }
+
+	// Variance of a single game result around the mean score
+	double Variance() const {
+		if (!Games()) return 0.0;
+		double mean = Score();
+		return (wins * (1.0 - mean) * (1.0 - mean) + draws * (0.5 - mean) * (0.5 - mean) + losses * mean * mean) / Games();
+	}
+};
+
+static double EloToScore(double elo) {
+	return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+static double ScoreToElo(double score) {
+	score = std::max(1e-6, std::min(1.0 - 1e-6, score));
+	return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+// Log-likelihood ratio of H1 (elo1) against H0 (elo0), normal approximation of the game results
+static double SprtLLR(const MatchStats& stats, double elo0, double elo1) {
+	// Identical results give no variance estimate: one extra draw keeps the ratio finite
+	MatchStats sample = stats;
+	if (sample.Variance() <= 0.0) sample.draws++;
+	double variance = sample.Variance();
+	if (variance <= 0.0) return 0.0;
+
+	double s0 = EloToScore(elo0);
+	double s1 = EloToScore(elo1);
+	return sample.Games() * (s1 - s0) * (2.0 * sample.Score() - s0 - s1) / (2.0 * variance);
+}
+
+bool ParseEngineSpec(const char* spec, AILevelSettings& settings) {
+	const char* colon = strchr(spec, ':');
+	size_t nameLength = colon ? static_cast<size_t>(colon - spec) : strlen(spec);
+
+	for (int level = 0; level < static_cast<int>(AIDifficulty::DIFFICULTY_COUNT); level++) {
+		if (strlen(LEVEL_NAMES[level]) != nameLength || strncmp(spec, LEVEL_NAMES[level], nameLength) != 0) continue;
+
+		settings = AI_LEVEL_SETTINGS[level];
+		if (settings.timeLimitMs) {
+			if (!settings.nodeLimit) settings.nodeLimit = uint64_t(settings.timeLimitMs) * TOURNAMENT_NODES_PER_MS;
+			settings.timeLimitMs = 0;
+		}
+		if (colon) {
+			// Depth for alpha-beta levels, playouts for tree search levels
+			int value = atoi(colon + 1);
+			if (value < 1) return false;
+			if (settings.useMcts) settings.nodeLimit = static_cast<uint64_t>(value);
+			else settings.maxDepth = value;
+		}
+		return true;
+	}
+	return false;
+}
+
+static bool LoadOpenings(const TournamentOptions& options, std::vector<std::string>& openings) {
+	if (options.openingsFile.empty()) {
+		openings.assign(std::begin(BALANCED_OPENINGS), std::end(BALANCED_OPENINGS));
+	}
+	else {
+		std::ifstream file(options.openingsFile);
+		if (!file) {
+			std::cerr << "Cannot open " << options.openingsFile << "\n";
+			return false;
+		}
+		std::string line;
+		while (std::getline(file, line)) {
+			line.erase(0, line.find_first_not_of(" \t\r"));
+			line.erase(line.find_last_not_of(" \t\r") + 1);
+			if (!line.empty() && line[0] != '#') openings.push_back(line);
+		}
+	}
+
+	for (const std::string& opening : openings) {
+		Board board;
+		board.Reset();
+		char player = BLACK_PIECE;
+		if (!PlayMoveSequence(board, player, opening.c_str())) {
+			std::cerr << "Invalid opening: " << opening << "\n";
+			return false;
+		}
+	}
+
+	if (openings.empty()) {
+		std::cerr << "No openings\n";
+		return false;
+	}
+	return true;
+}
+
+// Names the side and the move of an engine that played an illegal move
+static std::string DescribeIllegalMove(char player, std::pair<int, int> move, int size) {
+	std::string text = "illegal move ";
+	if (move.first < 0 || move.first >= size || move.second < 0 || move.second >= size) text += "(none)";
+	else if (size == BOARD_SIZE) text += SquareName(move.first * BOARD_SIZE + move.second);
+	else text += "row " + std::to_string(move.first + 1) + " column " + std::to_string(move.second + 1);
+	return text + " by " + ((player == BLACK_PIECE) ? "black" : "white");
+}
+
+// Plays one game from the opening and sets black's disc difference.
+// Returns false with a description in error when an engine plays an illegal move.
+static bool PlayGame(AI& black, AI& white, const std::string& opening, int& blackDiff, std::string& error) {
+	Board board;
+	board.Reset();
+	char player = BLACK_PIECE;
+	PlayMoveSequence(board, player, opening.c_str());
+
+	for (;;) {
+		if (!board.GetValidMoves(player)) {
+			if (!board.GetValidMoves(OpponentOf(player))) break;
+			player = OpponentOf(player);
+		}
+
+		AI& engine = (player == BLACK_PIECE) ? black : white;
+		std::pair<int, int> move = engine.MakeMove(board, player);
+		bool onBoard = move.first >= 0 && move.first < BOARD_SIZE && move.second >= 0 && move.second < BOARD_SIZE;
+		if (!onBoard || !board.MakeMove(move.first, move.second, player)) {
+			error = DescribeIllegalMove(player, move, BOARD_SIZE) + " after opening " + opening;
+			return false;
+		}
+		player = OpponentOf(player);
+	}
+
+	blackDiff = board.CountPieces(BLACK_PIECE) - board.CountPieces(WHITE_PIECE);
+	return true;
+}
+
+static void PrintStats(const MatchStats& stats, const TournamentOptions& options) {
+	double score = stats.Score();
+	double margin = 1.96 * std::sqrt(stats.Variance() / std::max(stats.Games(), 1));
+	double elo = ScoreToElo(score);
+	double eloLow = ScoreToElo(score - margin);
+	double eloHigh = ScoreToElo(score + margin);
+
+	double lowerBound = std::log(options.beta / (1.0 - options.alpha));
+	double upperBound = std::log((1.0 - options.beta) / options.alpha);
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< "Games " << stats.Games() << " (+" << stats.wins << " =" << stats.draws << " -" << stats.losses << ")"
+		<< "  score " << score * 100.0 << "%"
+		<< "  Elo " << std::showpos << elo << std::noshowpos << " [" << eloLow << ", " << eloHigh << "]"
+		<< std::setprecision(2)
+		<< "  LLR " << SprtLLR(stats, options.elo0, options.elo1) << " (" << lowerBound << ", " << upperBound << ")\n";
+}
+
+int RunTournament(const TournamentOptions& options) {
+	std::vector<std::string> openings;
+	if (!LoadOpenings(options, openings)) return 1;
+
+	int threadCount = options.threads;
+	if (threadCount < 1) threadCount = static_cast<int>(std::thread::hardware_concurrency());
+	if (threadCount < 1) threadCount = 1;
+
+	int totalGames = (std::max(options.games, 1) + 1) / 2 * 2;
+	double lowerBound = std::log(options.beta / (1.0 - options.alpha));
+	double upperBound = std::log((1.0 - options.beta) / options.alpha);
+
+	std::cout << "Tournament: " << totalGames << " games, " << openings.size() << " openings, "
+		<< threadCount << " threads, seed " << options.seed << "\n";
+	std::cout << "SPRT: H0 Elo " << options.elo0 << ", H1 Elo " << options.elo1
+		<< ", alpha " << options.alpha << ", beta " << options.beta << "\n";
+
+	MatchStats stats;
+	std::mutex statsMutex;
+	std::atomic<int> nextGame{ 0 };
+	std::atomic<bool> stop{ false };
+	int sprtResult = 0;         // 1 = H1 accepted, -1 = H0 accepted
+	std::string engineError;    // First illegal move, aborts the match
+
+	// Thread pool: every worker owns both engines and pulls game numbers until the match ends
+	auto worker = [&]() {
+		AI engineA;
+		AI engineB;
+		engineA.SetLimits(options.engineA);
+		engineB.SetLimits(options.engineB);
+		engineA.SetThreadCount(1);
+		engineB.SetThreadCount(1);
+
+		for (;;) {
+			int game = nextGame++;
+			if (game >= totalGames || stop) break;
+
+			// Each opening is played twice with the colors swapped. Seeds depend only on the
+			// game number, so every game is the same whichever thread plays it.
+			const std::string& opening = openings[(game / 2) % openings.size()];
+			bool aIsBlack = (game % 2) == 0;
+			engineA.ClearTables();
+			engineB.ClearTables();
+			engineA.SetSeed(options.seed * 1000003ULL + game * 2ULL);
+			engineB.SetSeed(options.seed * 1000003ULL + game * 2ULL + 1);
+
+			int blackDiff = 0;
+			std::string error;
+			bool played = aIsBlack ? PlayGame(engineA, engineB, opening, blackDiff, error) : PlayGame(engineB, engineA, opening, blackDiff, error);
+			int diff = aIsBlack ? blackDiff : -blackDiff;
+
+			std::lock_guard<std::mutex> lock(statsMutex);
+			if (!played) {
+				if (engineError.empty()) engineError = "Game " + std::to_string(game + 1) + " (A plays " + (aIsBlack ? "black" : "white") + "): " + error;
+				stop = true;
+				break;
+			}
+			if (stop) break;
+			if (diff > 0) stats.wins++;
+			else if (diff < 0) stats.losses++;
+			else stats.draws++;
+
+			if (stats.Games() % 50 == 0 && stats.Games() < totalGames) PrintStats(stats, options);
+
+			double llr = SprtLLR(stats, options.elo0, options.elo1);
+			if (llr >= upperBound) sprtResult = 1;
+			else if (llr <= lowerBound) sprtResult = -1;
+			if (sprtResult) stop = true;
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (int i = 0; i < threadCount; i++) pool.emplace_back(worker);
+	for (auto& thread : pool) thread.join();
+
+	if (!engineError.empty()) {
+		std::cerr << engineError << "\nTournament aborted\n";
+		return 1;
+	}
+
+	PrintStats(stats, options);
+	if (sprtResult > 0) std::cout << "SPRT: H1 accepted (A is " << options.elo1 << " Elo or more ahead of B)\n";
+	else if (sprtResult < 0) std::cout << "SPRT: H0 accepted (A is " << options.elo0 << " Elo or less ahead of B)\n";
+	else std::cout << "SPRT: inconclusive\n";
+	return 0;
+}
+
+// Plays one game on a board of another size from the start position, as PlayGame
+template <int Size>
+static bool PlayVariantGame(VariantAI<Size>& black, VariantAI<Size>& white, int& blackDiff, std::string& error) {
+	VariantBoard<Size> board;
+	board.Reset();
+	char player = BLACK_PIECE;
+
+	for (;;) {
+		if (!board.GetValidMoves(player)) {
+			if (!board.GetValidMoves(OpponentOf(player))) break;
+			player = OpponentOf(player);
+		}
+
+		VariantAI<Size>& engine = (player == BLACK_PIECE) ? black : white;
+		std::pair<int, int> move = engine.MakeMove(board, player);
+		bool onBoard = move.first >= 0 && move.first < Size && move.second >= 0 && move.second < Size;
+		if (!onBoard || !board.MakeMove(move.first, move.second, player)) {
+			error = DescribeIllegalMove(player, move, Size);
+			return false;
+		}
+		player = OpponentOf(player);
+	}
+
+	blackDiff = PopCount(board.black) - PopCount(board.white);
+	return true;
+}
+
+template <int Size>
+static int VariantMatch(AIDifficulty levelA, AIDifficulty levelB, int games, uint64_t seed) {
+	VariantAI<Size> engineA(levelA);
+	VariantAI<Size> engineB(levelB);
+	MatchStats stats;
+
+	std::cout << Size << "x" << Size << " match: " << LEVEL_NAMES[static_cast<int>(levelA)] << " vs "
+		<< LEVEL_NAMES[static_cast<int>(levelB)] << ", " << games << " games\n";
+
+	for (int game = 0; game < games; game++) {
+		bool aIsBlack = (game % 2) == 0;
+		engineA.SetSeed(seed * 1000003ULL + game * 2ULL);
+		engineB.SetSeed(seed * 1000003ULL + game * 2ULL + 1);
+
+		int blackDiff = 0;
+		std::string error;
+		bool played = aIsBlack ? PlayVariantGame<Size>(engineA, engineB, blackDiff, error) : PlayVariantGame<Size>(engineB, engineA, blackDiff, error);
+		if (!played) {
+			std::cerr << "Game " << game + 1 << " (A plays " << (aIsBlack ? "black" : "white") << "): " << error << "\nMatch aborted\n";
+			return 1;
+		}
+		int diff = aIsBlack ? blackDiff : -blackDiff;
+		if (diff > 0) stats.wins++;
+		else if (diff < 0) stats.losses++;
+		else stats.draws++;
+		std::cout << "Game " << game + 1 << ": A plays " << (aIsBlack ? "black" : "white") << ", " << std::showpos << diff << std::noshowpos << "\n";
+	}
+
+	std::cout << std::fixed << std::setprecision(1)
+		<< "Games " << stats.Games() << " (+" << stats.wins << " =" << stats.draws << " -" << stats.losses << ")"
+		<< "  score " << stats.Score() * 100.0 << "%"
+		<< "  Elo " << std::showpos << ScoreToElo(stats.Score()) << std::noshowpos << "\n";
+	return 0;
+}
+
+int RunVariantMatch(int size, const char* levelA, const char* levelB, int games, uint64_t seed) {
+	int levels[2] = { -1, -1 };
+	const char* names[2] = { levelA, levelB };
+	for (int i = 0; i < 2; i++) {
+		for (int level = 0; level < static_cast<int>(AIDifficulty::DIFFICULTY_COUNT); level++) {
+			if (strcmp(names[i], LEVEL_NAMES[level]) == 0) levels[i] = level;
+		}
+		if (levels[i] < 0) {
+			std::cerr << "Unknown level " << names[i] << "\n";
+			return 1;
+		}
+	}
+
+	AIDifficulty a = static_cast<AIDifficulty>(levels[0]);
+	AIDifficulty b = static_cast<AIDifficulty>(levels[1]);
+	games = std::max(games, 1);
+	switch (size) {
+	case 6: return VariantMatch<6>(a, b, games, seed);
+	case 8: return VariantMatch<8>(a, b, games, seed);
+	case 10: return VariantMatch<10>(a, b, games, seed);
+	default:
+		std::cerr << "Board size must be 6, 8 or 10\n";
+		return 1;
+	}
+}
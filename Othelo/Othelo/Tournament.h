@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AI.h"
+
+// Engine-vs-engine matches (console output only, no SDL)
+
+#define TOURNAMENT_NODES_PER_MS     2000    // Node budget replacing level time limits, so games are reproducible
+
+struct TournamentOptions {
+	AILevelSettings engineA;
+	AILevelSettings engineB;
+	int games = 1000;                   // Rounded up to whole pairs: every opening is played with both colors
+	int threads = 0;                    // 0 = all cores
+	uint64_t seed = 1;
+	std::string openingsFile;           // One move line per line ("f5d6c3..."), empty = built-in set
+
+	// SPRT hypotheses (Elo of A over B) and error rates
+	double elo0 = 0.0;
+	double elo1 = 10.0;
+	double alpha = 0.05;
+	double beta = 0.05;
+};
+
+// Parses "easy", "medium", "hard" or "expert", optionally followed by ":depth"
+// (":playouts" for the levels using Monte Carlo Tree Search).
+// Time limits become node budgets, so a match plays the same games on every run.
+bool ParseEngineSpec(const char* spec, AILevelSettings& settings);
+
+// Plays the match on a thread pool and prints Elo, error bars and the SPRT state.
+// Stops early once the SPRT accepts either hypothesis, aborts with an error when an engine plays an illegal move.
+int RunTournament(const TournamentOptions& options);
+
+// Level against level on a 6x6, 8x8 or 10x10 board with the size-specialized AI (VariantAI),
+// colors alternating. The levels keep their time limits, so results vary between runs.
+// Aborts with an error when an engine plays an illegal move.
+int RunVariantMatch(int size, const char* levelA, const char* levelB, int games, uint64_t seed);
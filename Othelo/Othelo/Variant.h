@@ -0,0 +1,410 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <random>
+#include <type_traits>
+#include <utility>
+#include "Board.h"
+#include "AI.h"
+
+// Othello on other board sizes (6x6, 8x8, 10x10), with the rules and the AI as templates on the size.
+// Every size gets its own masks, tables and loop bounds at compile time, so the hot loops carry no
+// runtime size checks. The standard game keeps its tuned engine (Board.h, AI.h); the 8x8 instance
+// of these templates is checked against it.
+//
+// Square index = row * Size + col, like the standard board
+
+// 128-bit bitboard for boards of more than 64 cells
+struct Bitboard128 {
+	uint64_t low;
+	uint64_t high;
+
+	constexpr Bitboard128() : low(0), high(0) {}
+	constexpr Bitboard128(uint64_t lowBits, uint64_t highBits = 0) : low(lowBits), high(highBits) {}
+
+	constexpr explicit operator bool() const { return (low | high) != 0; }
+	constexpr bool operator==(const Bitboard128& other) const { return low == other.low && high == other.high; }
+	constexpr bool operator!=(const Bitboard128& other) const { return !(*this == other); }
+
+	constexpr Bitboard128 operator&(const Bitboard128& other) const { return Bitboard128(low & other.low, high & other.high); }
+	constexpr Bitboard128 operator|(const Bitboard128& other) const { return Bitboard128(low | other.low, high | other.high); }
+	constexpr Bitboard128 operator^(const Bitboard128& other) const { return Bitboard128(low ^ other.low, high ^ other.high); }
+	constexpr Bitboard128 operator~() const { return Bitboard128(~low, ~high); }
+	Bitboard128& operator&=(const Bitboard128& other) { low &= other.low; high &= other.high; return *this; }
+	Bitboard128& operator|=(const Bitboard128& other) { low |= other.low; high |= other.high; return *this; }
+	Bitboard128& operator^=(const Bitboard128& other) { low ^= other.low; high ^= other.high; return *this; }
+
+	constexpr Bitboard128 operator<<(int shift) const {
+		return (shift == 0) ? *this
+			: (shift >= 64) ? Bitboard128(0, low << (shift - 64))
+			: Bitboard128(low << shift, (high << shift) | (low >> (64 - shift)));
+	}
+	constexpr Bitboard128 operator>>(int shift) const {
+		return (shift == 0) ? *this
+			: (shift >= 64) ? Bitboard128(high >> (shift - 64), 0)
+			: Bitboard128((low >> shift) | (high << (64 - shift)), high >> shift);
+	}
+
+	bool Test(int square) const { return ((square < 64) ? (low >> square) : (high >> (square - 64))) & 1; }
+};
+
+// Same helpers as Board.h, so templates can use either bitboard type
+inline int PopCount(const Bitboard128& b) {
+	return PopCount(b.low) + PopCount(b.high);
+}
+
+inline int LowestBitIndex(const Bitboard128& b) {
+	return b.low ? LowestBitIndex(b.low) : 64 + LowestBitIndex(b.high);
+}
+
+inline int PopLowestBit(Bitboard128& b) {
+	if (b.low) return PopLowestBit(b.low);
+	return 64 + PopLowestBit(b.high);
+}
+
+inline void ToggleMove(Bitboard128& player, Bitboard128& opponent, Bitboard128 placed, Bitboard128 flips) {
+	player ^= placed | flips;
+	opponent ^= flips;
+}
+
+// Masks and move generation of one board size
+template <int Size>
+struct VariantRules {
+	static_assert(Size >= 4 && Size % 2 == 0 && Size * Size <= 128, "Board sizes are even, from 4x4 to 10x10");
+
+	static constexpr int CELLS = Size * Size;
+	typedef typename std::conditional<(CELLS <= 64), uint64_t, Bitboard128>::type Bits;
+
+	static constexpr Bits SquareBit(int square) { return Bits(1) << square; }
+
+	static constexpr Bits FullMask() {
+		Bits mask = 0;
+		for (int square = 0; square < CELLS; square++) mask = mask | SquareBit(square);
+		return mask;
+	}
+
+	static constexpr Bits ColumnMask(int col) {
+		Bits mask = 0;
+		for (int row = 0; row < Size; row++) mask = mask | SquareBit(row * Size + col);
+		return mask;
+	}
+
+	// Directions 0-3 shift towards higher squares (E, S, SE, SW), 4-7 towards lower ones (W, N, NW, NE)
+	static constexpr int DirectionShift(int direction) {
+		return ((direction & 3) == 0) ? 1 : ((direction & 3) == 1) ? Size : ((direction & 3) == 2) ? Size + 1 : Size - 1;
+	}
+
+	// Squares a shifted disc can land on: the column it would wrap into and the bits past the board are cut
+	static constexpr Bits DirectionMask(int direction) {
+		return (direction == 0 || direction == 2 || direction == 7) ? FullMask() & ~ColumnMask(0)
+			: (direction == 3 || direction == 4 || direction == 6) ? FullMask() & ~ColumnMask(Size - 1)
+			: FullMask();
+	}
+
+	template <int Direction>
+	static Bits Shift(Bits b) {
+		constexpr int shift = DirectionShift(Direction);
+		constexpr Bits mask = DirectionMask(Direction);
+		return ((Direction < 4) ? (b << shift) : (b >> shift)) & mask;
+	}
+
+	// A line of opponent discs is at most Size - 2 long, so the fill runs a fixed number of steps
+	template <int Direction>
+	static Bits MovesInDirection(Bits player, Bits opponent, Bits empty) {
+		Bits run = Shift<Direction>(player) & opponent;
+		for (int i = 0; i < Size - 3; i++) run |= Shift<Direction>(run) & opponent;
+		return Shift<Direction>(run) & empty;
+	}
+
+	template <int Direction>
+	static Bits FlipsInDirection(Bits move, Bits player, Bits opponent) {
+		Bits flips = 0;
+		Bits cursor = Shift<Direction>(move);
+		for (int i = 0; i < Size - 2 && (cursor & opponent); i++) {
+			flips |= cursor;
+			cursor = Shift<Direction>(cursor);
+		}
+		return (cursor & player) ? flips : Bits(0);
+	}
+
+	static Bits GetMoves(Bits player, Bits opponent) {
+		Bits empty = FullMask() & ~(player | opponent);
+		return MovesInDirection<0>(player, opponent, empty) | MovesInDirection<1>(player, opponent, empty)
+			| MovesInDirection<2>(player, opponent, empty) | MovesInDirection<3>(player, opponent, empty)
+			| MovesInDirection<4>(player, opponent, empty) | MovesInDirection<5>(player, opponent, empty)
+			| MovesInDirection<6>(player, opponent, empty) | MovesInDirection<7>(player, opponent, empty);
+	}
+
+	static Bits GetFlips(int square, Bits player, Bits opponent) {
+		Bits move = SquareBit(square);
+		return FlipsInDirection<0>(move, player, opponent) | FlipsInDirection<1>(move, player, opponent)
+			| FlipsInDirection<2>(move, player, opponent) | FlipsInDirection<3>(move, player, opponent)
+			| FlipsInDirection<4>(move, player, opponent) | FlipsInDirection<5>(move, player, opponent)
+			| FlipsInDirection<6>(move, player, opponent) | FlipsInDirection<7>(move, player, opponent);
+	}
+};
+
+// Board position of one size, same interface as Board
+template <int Size>
+struct VariantBoard {
+	typedef VariantRules<Size> Rules;
+	typedef typename Rules::Bits Bits;
+
+	Bits black = 0;
+	Bits white = 0;
+
+	void Reset() {
+		const int center = Size / 2;
+		black = Rules::SquareBit((center - 1) * Size + center) | Rules::SquareBit(center * Size + center - 1);
+		white = Rules::SquareBit((center - 1) * Size + center - 1) | Rules::SquareBit(center * Size + center);
+	}
+
+	void Clear() {
+		black = 0;
+		white = 0;
+	}
+
+	Bits& Pieces(char player) { return (player == BLACK_PIECE) ? black : white; }
+	Bits Pieces(char player) const { return (player == BLACK_PIECE) ? black : white; }
+
+	char GetPiece(int row, int col) const {
+		Bits mask = Rules::SquareBit(row * Size + col);
+		if (black & mask) return BLACK_PIECE;
+		if (white & mask) return WHITE_PIECE;
+		return EMPTY_PIECE;
+	}
+
+	void SetPiece(int row, int col, char piece) {
+		Bits mask = Rules::SquareBit(row * Size + col);
+		black &= ~mask;
+		white &= ~mask;
+		if (piece == BLACK_PIECE) black |= mask;
+		else if (piece == WHITE_PIECE) white |= mask;
+	}
+
+	Bits GetValidMoves(char player) const {
+		return Rules::GetMoves(Pieces(player), Pieces(OpponentOf(player)));
+	}
+
+	// Returns the flipped discs, 0 if the move is illegal
+	Bits MakeMove(int row, int col, char player) {
+		int square = row * Size + col;
+		Bits& own = Pieces(player);
+		Bits& other = Pieces(OpponentOf(player));
+		if (!(Rules::GetMoves(own, other) & Rules::SquareBit(square))) return 0;
+
+		Bits flips = Rules::GetFlips(square, own, other);
+		ToggleMove(own, other, Rules::SquareBit(square), flips);
+		return flips;
+	}
+};
+
+// Square weights from the distance to the edges: corners are worth the most, the squares next to
+// them the least, edges a little
+template <int Size>
+struct VariantSquareWeights {
+	int values[Size * Size];
+
+	constexpr VariantSquareWeights() : values() {
+		for (int row = 0; row < Size; row++) {
+			for (int col = 0; col < Size; col++) {
+				int rowEdge = std::min(row, Size - 1 - row);
+				int colEdge = std::min(col, Size - 1 - col);
+				int edge = std::min(rowEdge, colEdge);
+				int other = std::max(rowEdge, colEdge);
+				values[row * Size + col] = (edge == 0 && other == 0) ? 100     // Corner
+					: (edge == 1 && other == 1) ? -50                           // X-square
+					: (edge == 0 && other == 1) ? -20                           // C-square
+					: (edge == 0) ? 10                                          // Edge
+					: (edge == 1) ? -5                                          // Second ring
+					: 1;
+			}
+		}
+	}
+};
+
+// Search budget of each difficulty on the other board sizes (the playing strength roughly follows the standard levels)
+struct VariantLevelSettings {
+	int maxDepth;
+	int timeLimitMs;
+	int endgameEmpties;         // Search to the end of the game from this many empty squares down
+	int randomMovePercent;      // Chance of playing a random legal move instead of searching
+};
+
+static const VariantLevelSettings VARIANT_LEVEL_SETTINGS[] = {
+	{ 2,  100,  0,  20 },       // EASY
+	{ 4,  250,  8,  0 },        // MEDIUM
+	{ 8,  1500, 14, 0 },        // HARD
+	{ 40, 4000, 18, 0 }         // EXPERT
+};
+
+#define VARIANT_MAX_PLY             (2 * 128)   // Moves and passes of the longest game on the largest board
+#define VARIANT_MOBILITY_WEIGHT     8
+#define VARIANT_CHECK_INTERVAL      1023        // Nodes between time checks (mask)
+
+// Alpha-beta AI of one board size: iterative deepening negamax with square-weight move ordering,
+// searched to the end of the game near the end. Same threading model as AI (one background search).
+template <int Size>
+class VariantAI {
+public:
+	typedef VariantRules<Size> Rules;
+	typedef typename Rules::Bits Bits;
+
+	explicit VariantAI(AIDifficulty difficulty = AIDifficulty::EASY) : random(std::random_device{}()) { SetDifficulty(difficulty); }
+
+	void SetDifficulty(AIDifficulty difficulty) { settings = VARIANT_LEVEL_SETTINGS[static_cast<int>(difficulty)]; }
+	void SetSeed(uint64_t seed) { random.seed(static_cast<std::mt19937::result_type>(seed ^ (seed >> 32))); }
+
+	// Returns { row, col }, { -1, -1 } when the player has to pass
+	std::pair<int, int> MakeMove(const VariantBoard<Size>& board, char player) {
+		stopRequested = false;
+		return Search(board.Pieces(player), board.Pieces(OpponentOf(player)));
+	}
+
+	// Background search: the result arrives through the future, Stop() makes it return early
+	std::future<std::pair<int, int>> StartSearch(const VariantBoard<Size>& board, char player) {
+		stopRequested = false;
+		Bits own = board.Pieces(player);
+		Bits other = board.Pieces(OpponentOf(player));
+		return std::async(std::launch::async, [this, own, other]() {
+			return Search(own, other);
+		});
+	}
+	void Stop() { stopRequested = true; }
+
+	// Statistics of the last search
+	uint64_t GetNodeCount() const { return nodes; }
+	int GetLastDepth() const { return completedDepth; }
+	int GetLastScore() const { return lastScore; }
+
+private:
+	static constexpr VariantSquareWeights<Size> WEIGHTS = VariantSquareWeights<Size>();
+
+	VariantLevelSettings settings;
+	std::atomic<bool> stopRequested{ false };
+	bool stopSearch = false;
+	uint64_t nodes = 0;
+	int completedDepth = 0;
+	int lastScore = 0;
+	std::chrono::steady_clock::time_point searchStart;
+	std::mt19937 random;
+
+	std::pair<int, int> Search(Bits player, Bits opponent) {
+		Bits moves = Rules::GetMoves(player, opponent);
+		nodes = 0;
+		completedDepth = 0;
+		if (!moves) return { -1, -1 };
+
+		if (settings.randomMovePercent > 0 && static_cast<int>(random() % 100) < settings.randomMovePercent) {
+			int skip = static_cast<int>(random() % PopCount(moves));
+			while (skip--) PopLowestBit(moves);
+			int square = LowestBitIndex(moves);
+			return { square / Size, square % Size };
+		}
+
+		searchStart = std::chrono::steady_clock::now();
+		stopSearch = false;
+
+		int empties = Rules::CELLS - PopCount(player | opponent);
+		int maxDepth = std::min(settings.maxDepth, empties);
+		if (empties <= settings.endgameEmpties) maxDepth = empties;
+
+		int bestMove = LowestBitIndex(moves);
+		for (int depth = 1; depth <= maxDepth; depth++) {
+			int move = bestMove;
+			int score = SearchRoot(player, opponent, depth, move);
+			if (stopSearch) break;
+			bestMove = move;
+			lastScore = score;
+			completedDepth = depth;
+			if (score > SCORE_EVAL_LIMIT || score < -SCORE_EVAL_LIMIT) break;   // Proven result
+		}
+		return { bestMove / Size, bestMove % Size };
+	}
+
+	int SearchRoot(Bits player, Bits opponent, int depth, int& bestMove) {
+		int moveList[Rules::CELLS];
+		int count = OrderMoves(Rules::GetMoves(player, opponent), bestMove, moveList);
+
+		int alpha = -SCORE_INFINITY;
+		for (int i = 0; i < count; i++) {
+			Bits placed = Rules::SquareBit(moveList[i]);
+			Bits flips = Rules::GetFlips(moveList[i], player, opponent);
+			ToggleMove(player, opponent, placed, flips);
+			int score = -Negamax(opponent, player, depth - 1, -SCORE_INFINITY, -alpha, 1, false);
+			ToggleMove(player, opponent, placed, flips);
+			if (stopSearch) break;
+			if (score > alpha) {
+				alpha = score;
+				bestMove = moveList[i];
+			}
+		}
+		return alpha;
+	}
+
+	int Negamax(Bits player, Bits opponent, int depth, int alpha, int beta, int ply, bool passed) {
+		if ((++nodes & VARIANT_CHECK_INTERVAL) == 0) CheckLimits();
+		if (stopSearch) return 0;
+
+		Bits moves = Rules::GetMoves(player, opponent);
+		if (!moves) {
+			if (passed || !Rules::GetMoves(opponent, player)) return FinalScore(player, opponent);
+			return -Negamax(opponent, player, depth, -beta, -alpha, ply + 1, true);
+		}
+		if (depth <= 0 || ply >= VARIANT_MAX_PLY) return Evaluate(player, opponent, moves);
+
+		int moveList[Rules::CELLS];
+		int count = OrderMoves(moves, -1, moveList);
+		int best = -SCORE_INFINITY;
+		for (int i = 0; i < count; i++) {
+			Bits placed = Rules::SquareBit(moveList[i]);
+			Bits flips = Rules::GetFlips(moveList[i], player, opponent);
+			ToggleMove(player, opponent, placed, flips);
+			int score = -Negamax(opponent, player, depth - 1, -beta, -alpha, ply + 1, false);
+			ToggleMove(player, opponent, placed, flips);
+			if (score > best) best = score;
+			if (score > alpha) alpha = score;
+			if (alpha >= beta) break;
+		}
+		return best;
+	}
+
+	// Best square weight first, the previous iteration's move before everything
+	int OrderMoves(Bits moves, int firstMove, int* moveList) const {
+		int count = 0;
+		while (moves) {
+			int move = PopLowestBit(moves);
+			int i = count++;
+			int weight = (move == firstMove) ? SCORE_INFINITY : WEIGHTS.values[move];
+			while (i > 0 && ((moveList[i - 1] == firstMove) ? SCORE_INFINITY : WEIGHTS.values[moveList[i - 1]]) < weight) {
+				moveList[i] = moveList[i - 1];
+				i--;
+			}
+			moveList[i] = move;
+		}
+		return count;
+	}
+
+	int Evaluate(Bits player, Bits opponent, Bits moves) const {
+		int score = 0;
+		while (player) score += WEIGHTS.values[PopLowestBit(player)];
+		while (opponent) score -= WEIGHTS.values[PopLowestBit(opponent)];
+		return score + VARIANT_MOBILITY_WEIGHT * PopCount(moves);
+	}
+
+	static int FinalScore(Bits player, Bits opponent) {
+		int diff = PopCount(player) - PopCount(opponent);
+		return (diff > 0) ? SCORE_WIN + diff : (diff < 0) ? -SCORE_WIN + diff : 0;
+	}
+
+	void CheckLimits() {
+		int elapsedMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStart).count());
+		if (stopRequested || (settings.timeLimitMs > 0 && elapsedMs >= settings.timeLimitMs)) stopSearch = true;
+	}
+};
+
+template <int Size>
+constexpr VariantSquareWeights<Size> VariantAI<Size>::WEIGHTS;
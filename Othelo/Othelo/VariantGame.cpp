@@ -0,0 +1,81 @@
+#include "VariantGame.h"
+
+template <typename Entry>
+static bool ToCellMove(const Entry* entry, CellMove& move) {
+	if (!entry) return false;
+	move.square = entry->square;
+	move.player = entry->player;
+	move.flips = CellSet(entry->flips);
+	return true;
+}
+
+// One board size: the board, its takeback history and the AI. The AI member is a reference for the
+// standard game (the tuned AI outlives the game) and owned for the other sizes.
+template <typename BoardType, typename AIMember, int Size>
+class BoardGame : public VariantGame {
+public:
+	BoardGame() { board.Reset(); }
+	explicit BoardGame(AIMember gameAI) : ai(gameAI) { board.Reset(); }
+
+	int GetSize() const override { return Size; }
+	void Reset() override {
+		board.Reset();
+		history.Clear();
+	}
+	void Clear() override {
+		board.Clear();
+		history.Clear();
+	}
+	char GetPiece(int row, int col) const override { return board.GetPiece(row, col); }
+	void SetPiece(int row, int col, char piece) override {
+		board.SetPiece(row, col, piece);
+		history.Clear();
+	}
+	CellSet GetPieces(char player) const override { return CellSet(board.Pieces(player)); }
+	CellSet GetValidMoves(char player) const override { return CellSet(board.GetValidMoves(player)); }
+
+	CellSet MakeMove(int row, int col, char player) override {
+		auto flips = board.MakeMove(row, col, player);
+		if (flips) history.Push(row * GetSize() + col, flips, player);
+		return CellSet(flips);
+	}
+	bool Undo(CellMove& move) override { return ToCellMove(history.Undo(board), move); }
+	bool Redo(CellMove& move) override { return ToCellMove(history.Redo(board), move); }
+	void ClearHistory() override { history.Clear(); }
+
+	std::future<std::pair<int, int>> StartSearch(char player, AIDifficulty difficulty) override {
+		ai.SetDifficulty(difficulty);
+		return ai.StartSearch(board, player);
+	}
+	void Stop() override { ai.Stop(); }
+
+	Board* GetStandardBoard() override { return nullptr; }
+
+private:
+	BoardType board;
+	MoveStack<BoardType, Size * Size> history;
+	AIMember ai;
+};
+
+// 8x8: the bitboard engine and the tuned AI
+typedef BoardGame<Board, AI&, BOARD_SIZE> StandardGame;
+
+template <>
+Board* StandardGame::GetStandardBoard() { return &board; }
+
+// Other sizes: the size-specialized templates
+template <int Size>
+using TemplateGame = BoardGame<VariantBoard<Size>, VariantAI<Size>, Size>;
+
+std::unique_ptr<VariantGame> CreateVariantGame(int size, AI& standardAI) {
+	switch (size) {
+	case 6:
+		return std::unique_ptr<VariantGame>(new TemplateGame<6>());
+	case BOARD_SIZE:
+		return std::unique_ptr<VariantGame>(new StandardGame(standardAI));
+	case 10:
+		return std::unique_ptr<VariantGame>(new TemplateGame<10>());
+	default:
+		return nullptr;
+	}
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <future>
+#include <memory>
+#include <utility>
+#include "Variant.h"
+
+#define VARIANT_SIZES       { 6, 8, 10 }
+#define VARIANT_MAX_SIZE    10
+
+// Set of squares on any board size (square = row * size + col)
+typedef Bitboard128 CellSet;
+
+// A move taken back or played again
+struct CellMove {
+	int square;
+	char player;
+	CellSet flips;
+};
+
+// A game of one board size behind a runtime interface, for the UI. The 6x6 and 10x10 games run
+// the VariantBoard / VariantAI templates; the standard game runs Board and the tuned AI
+// (opening book, network, parallel search).
+class VariantGame {
+public:
+	virtual ~VariantGame() {}
+
+	virtual int GetSize() const = 0;
+	virtual void Reset() = 0;
+	virtual void Clear() = 0;
+	virtual char GetPiece(int row, int col) const = 0;
+	virtual void SetPiece(int row, int col, char piece) = 0;
+	virtual CellSet GetPieces(char player) const = 0;
+	virtual CellSet GetValidMoves(char player) const = 0;
+	virtual CellSet MakeMove(int row, int col, char player) = 0;       // Flipped discs, empty if the move is illegal
+
+	// Takeback over every move made since the last Reset, Clear or SetPiece. Undone moves can be
+	// played again until the next move. Both return false when there is nothing to do.
+	virtual bool Undo(CellMove& move) = 0;
+	virtual bool Redo(CellMove& move) = 0;
+	virtual void ClearHistory() = 0;       // For edits that change the game without a move (side to move)
+
+	// Background search, Stop() makes it return early. The result is { -1, -1 } when the player has to pass.
+	virtual std::future<std::pair<int, int>> StartSearch(char player, AIDifficulty difficulty) = 0;
+	virtual void Stop() = 0;
+
+	// The position as a standard Board (for game records), null on the other sizes
+	virtual Board* GetStandardBoard() { return nullptr; }
+
+	int CountPieces(char player) const { return PopCount(GetPieces(player)); }
+	bool IsFull() const { return PopCount(GetPieces(BLACK_PIECE) | GetPieces(WHITE_PIECE)) == GetSize() * GetSize(); }
+};
+
+// Returns null for a size without a game. The standard game plays with the given AI, which keeps
+// its book and network loaded between games.
+std::unique_ptr<VariantGame> CreateVariantGame(int size, AI& standardAI);
@@ -0,0 +1,368 @@
+#include "Wthor.h"
+#include "Book.h"
+#include "Pattern.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <thread>
+
+static uint32_t ReadLE32(const uint8_t* bytes) {
+	return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+static int ReadLE16(const uint8_t* bytes) {
+	return bytes[0] | (bytes[1] << 8);
+}
+
+bool WthorFile::Open(const char* path) {
+	Close();
+	if (!file.Open(path)) return false;
+
+	if (file.Size() < sizeof(WthorHeader)) {
+		Close();
+		return false;
+	}
+
+	header = reinterpret_cast<const WthorHeader*>(file.Data());
+	uint32_t count = ReadLE32(header->gameCount);
+	bool eightByEight = header->boardSize == 0 || header->boardSize == BOARD_SIZE;
+	if (!eightByEight || count > (file.Size() - sizeof(WthorHeader)) / sizeof(WthorGame)) {
+		Close();
+		return false;
+	}
+
+	games = reinterpret_cast<const WthorGame*>(file.Data() + sizeof(WthorHeader));
+	gameCount = static_cast<int>(count);
+	return true;
+}
+
+void WthorFile::Close() {
+	file.Close();
+	header = nullptr;
+	games = nullptr;
+	gameCount = 0;
+}
+
+int WthorFile::GetYear() const {
+	return header ? ReadLE16(header->gamesYear) : 0;
+}
+
+int WthorFile::DecodeMove(uint8_t move) {
+	int row = move / 10 - 1;
+	int col = move % 10 - 1;
+	if (row < 0 || row >= BOARD_SIZE || col < 0 || col >= BOARD_SIZE) return -1;
+	return row * BOARD_SIZE + col;
+}
+
+// A move played in a canonical position
+struct WthorKey {
+	Bitboard player;
+	Bitboard opponent;
+	int move;
+
+	bool operator==(const WthorKey& other) const {
+		return player == other.player && opponent == other.opponent && move == other.move;
+	}
+};
+
+// Outcomes for the player making the move
+struct WthorStats {
+	uint32_t games = 0;
+	uint32_t wins = 0;
+	uint32_t draws = 0;
+	int64_t discSum = 0;        // Final disc difference
+};
+
+// Open addressing with linear probing in one flat array (no allocation per entry, unlike
+// std::unordered_map). Grows at half load. Games stop sharing positions after a few
+// plies, so the table ends up with millions of entries.
+class WthorTable {
+public:
+	struct Entry {
+		WthorKey key;
+		WthorStats stats;
+	};
+
+	WthorTable() : entries(WTHOR_TABLE_INITIAL_SIZE), mask(WTHOR_TABLE_INITIAL_SIZE - 1) {}
+
+	// Slots without games are empty, so the caller must count a game in a new entry
+	WthorStats& operator[](const WthorKey& key) {
+		if (2 * (used + 1) > entries.size()) Grow();
+		Entry& entry = Probe(key);
+		if (entry.stats.games == 0) {
+			entry.key = key;
+			used++;
+		}
+		return entry.stats;
+	}
+
+	const WthorStats* Find(const WthorKey& key) const {
+		size_t index = Hash(key) & mask;
+		while (entries[index].stats.games) {
+			if (entries[index].key == key) return &entries[index].stats;
+			index = (index + 1) & mask;
+		}
+		return nullptr;
+	}
+
+	size_t Size() const { return used; }
+	const std::vector<Entry>& Entries() const { return entries; }  // Empty slots have no games
+
+	void Release() {
+		std::vector<Entry>().swap(entries);
+		used = 0;
+	}
+
+private:
+	static size_t Hash(const WthorKey& key) {
+		uint64_t hash = key.player * 0x9E3779B97F4A7C15ULL ^ (key.opponent + 0x632BE59BD9B4E019ULL + (key.player << 6));
+		hash ^= static_cast<uint64_t>(key.move) * 0xBF58476D1CE4E5B9ULL;
+		hash ^= hash >> 31;
+		return static_cast<size_t>(hash);
+	}
+
+	// Slot holding the key, or the empty slot where it goes (an entry is only kept once counted)
+	Entry& Probe(const WthorKey& key) {
+		size_t index = Hash(key) & mask;
+		while (entries[index].stats.games && !(entries[index].key == key)) {
+			index = (index + 1) & mask;
+		}
+		return entries[index];
+	}
+
+	void Grow() {
+		std::vector<Entry> old(entries.size() * 2);
+		old.swap(entries);
+		mask = entries.size() - 1;
+		for (const Entry& entry : old) {
+			if (entry.stats.games) Probe(entry.key) = entry;
+		}
+	}
+
+	std::vector<Entry> entries;
+	size_t mask;
+	size_t used = 0;
+};
+
+struct WthorChunk {
+	const WthorFile* file;
+	int first;
+	int count;
+};
+
+// Replays one game and adds its first plies to the table. Returns false, without
+// touching the table, if a move is illegal.
+static bool ScanGame(const WthorGame& game, int plies, WthorTable& table) {
+	WthorKey keys[WTHOR_MOVES];
+	bool blackMoved[WTHOR_MOVES];
+	int counted = 0;
+
+	Board board;
+	board.Reset();
+	Bitboard player = board.black;
+	Bitboard opponent = board.white;
+	bool blackToMove = true;
+
+	for (int ply = 0; ply < WTHOR_MOVES && game.moves[ply]; ply++) {
+		int square = WthorFile::DecodeMove(game.moves[ply]);
+		if (square < 0) return false;
+
+		// A side without moves passes implicitly
+		Bitboard moves = GetMovesMask(player, opponent);
+		if (!moves) {
+			std::swap(player, opponent);
+			blackToMove = !blackToMove;
+			moves = GetMovesMask(player, opponent);
+		}
+		if (!((moves >> square) & 1)) return false;
+
+		if (ply < plies) {
+			WthorKey& key = keys[counted];
+			int symmetry = CanonicalPosition(player, opponent, key.player, key.opponent);
+			key.move = TransformSquare(square, symmetry);
+			blackMoved[counted++] = blackToMove;
+		}
+
+		Bitboard flips = GetFlipsMask(square, player, opponent);
+		Bitboard placed = player | flips | (1ULL << square);
+		player = opponent & ~flips;
+		opponent = placed;
+		blackToMove = !blackToMove;
+	}
+
+	// The stored result gives the empty squares to the winner, so the counts add up to 64
+	int blackDifference = 2 * game.blackDiscs - BOARD_CELLS;
+	for (int i = 0; i < counted; i++) {
+		int difference = blackMoved[i] ? blackDifference : -blackDifference;
+		WthorStats& stats = table[keys[i]];
+		stats.games++;
+		stats.wins += (difference > 0);
+		stats.draws += (difference == 0);
+		stats.discSum += difference;
+	}
+	return true;
+}
+
+// Prints the most played line from the start position with the alternatives at each ply
+static void PrintMainLine(const WthorTable& table) {
+	Board board;
+	board.Reset();
+	Bitboard player = board.black;
+	Bitboard opponent = board.white;
+	std::string line;
+
+	for (int ply = 0; ply < WTHOR_EXPLORE_PLIES; ply++) {
+		Bitboard moves = GetMovesMask(player, opponent);
+		if (!moves) break;
+
+		struct Candidate {
+			int square;
+			WthorStats stats;
+		};
+		std::vector<Candidate> candidates;
+		uint64_t total = 0;
+
+		WthorKey key;
+		int symmetry = CanonicalPosition(player, opponent, key.player, key.opponent);
+		while (moves) {
+			int square = PopLowestBit(moves);
+			key.move = TransformSquare(square, symmetry);
+			const WthorStats* stats = table.Find(key);
+			if (!stats) continue;
+			candidates.push_back({ square, *stats });
+			total += stats->games;
+		}
+		if (candidates.empty()) break;
+
+		std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+			return a.stats.games > b.stats.games;
+		});
+
+		std::cout << "  " << (line.empty() ? "start" : line.c_str()) << ":";
+		for (size_t i = 0; i < candidates.size() && i < WTHOR_EXPLORE_MOVES; i++) {
+			const WthorStats& stats = candidates[i].stats;
+			char text[96];
+			snprintf(text, sizeof(text), "  %s %.1f%% (win %.1f%%, %+.1f)", SquareName(candidates[i].square).c_str(),
+				100.0 * stats.games / total, 100.0 * (stats.wins + 0.5 * stats.draws) / stats.games,
+				static_cast<double>(stats.discSum) / stats.games);
+			std::cout << text;
+		}
+		std::cout << "\n";
+
+		int square = candidates[0].square;
+		line += SquareName(square);
+		Bitboard flips = GetFlipsMask(square, player, opponent);
+		Bitboard placed = player | flips | (1ULL << square);
+		player = opponent & ~flips;
+		opponent = placed;
+		if (!GetMovesMask(player, opponent)) std::swap(player, opponent);
+	}
+}
+
+int RunWthorImport(const WthorOptions& options) {
+	auto start = std::chrono::steady_clock::now();
+
+	// Every file stays mapped for the whole scan, workers read the games in place
+	std::vector<std::unique_ptr<WthorFile>> files;
+	std::vector<WthorChunk> chunks;
+	long long totalGames = 0;
+	for (const std::string& path : options.files) {
+		std::unique_ptr<WthorFile> file(new WthorFile());
+		if (!file->Open(path.c_str())) {
+			std::cerr << "Skipping " << path << ": not an 8x8 WTHOR game file\n";
+			continue;
+		}
+		for (int first = 0; first < file->GetGameCount(); first += WTHOR_CHUNK_GAMES) {
+			chunks.push_back({ file.get(), first, std::min(WTHOR_CHUNK_GAMES, file->GetGameCount() - first) });
+		}
+		totalGames += file->GetGameCount();
+		files.push_back(std::move(file));
+	}
+	if (files.empty()) {
+		std::cerr << "No game files to import\n";
+		return 1;
+	}
+	if (chunks.empty()) {
+		std::cerr << "No games to import\n";
+		return 1;
+	}
+
+	int threadCount = options.threads;
+	if (threadCount < 1) threadCount = static_cast<int>(std::thread::hardware_concurrency());
+	if (threadCount < 1) threadCount = 1;
+	threadCount = std::min(threadCount, static_cast<int>(chunks.size()));
+
+	// One table per thread, merged at the end, so workers never share a lock
+	std::vector<WthorTable> tables(threadCount);
+	std::vector<long long> rejected(threadCount, 0);
+	std::atomic<size_t> nextChunk{ 0 };
+	int plies = std::max(0, std::min(options.plies, WTHOR_MOVES));
+
+	auto worker = [&](int index) {
+		WthorTable& table = tables[index];
+		for (;;) {
+			size_t chunkIndex = nextChunk.fetch_add(1);
+			if (chunkIndex >= chunks.size()) break;
+
+			const WthorChunk& chunk = chunks[chunkIndex];
+			for (int i = 0; i < chunk.count; i++) {
+				if (!ScanGame(chunk.file->GetGame(chunk.first + i), plies, table)) rejected[index]++;
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (int i = 0; i < threadCount; i++) pool.emplace_back(worker, i);
+	for (auto& thread : pool) thread.join();
+
+	WthorTable& merged = tables[0];
+	long long rejectedGames = rejected[0];
+	for (int i = 1; i < threadCount; i++) {
+		for (const WthorTable::Entry& entry : tables[i].Entries()) {
+			if (!entry.stats.games) continue;
+			WthorStats& stats = merged[entry.key];
+			stats.games += entry.stats.games;
+			stats.wins += entry.stats.wins;
+			stats.draws += entry.stats.draws;
+			stats.discSum += entry.stats.discSum;
+		}
+		tables[i].Release();
+		rejectedGames += rejected[i];
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "Scanned " << totalGames << " games from " << files.size() << " files in " << seconds << " s ("
+		<< static_cast<long long>(totalGames / std::max(seconds, 1e-9)) << " games/s, " << threadCount << " threads)\n"
+		<< rejectedGames << " games rejected (illegal moves), " << merged.Size() << " positions and moves in the first "
+		<< plies << " plies\n\nMost played line (share of games, mover's score, average disc difference):\n";
+	PrintMainLine(merged);
+
+	if (!options.bookFile.empty()) {
+		std::vector<BookEntry> entries;
+		for (const WthorTable::Entry& entry : merged.Entries()) {
+			const WthorStats& stats = entry.stats;
+			if (!stats.games || stats.games < static_cast<uint32_t>(options.minGames)) continue;
+
+			// Popular moves are picked more often, the score is the average disc difference in evaluator units
+			BookEntry bookEntry = {};
+			bookEntry.player = entry.key.player;
+			bookEntry.opponent = entry.key.opponent;
+			bookEntry.score = static_cast<int16_t>(std::lround(static_cast<double>(stats.discSum) * PATTERN_SCORE_PER_DISC / stats.games));
+			bookEntry.weight = static_cast<uint16_t>(std::min<uint32_t>(stats.games, 0xFFFF));
+			bookEntry.move = static_cast<uint8_t>(entry.key.move);
+			entries.push_back(bookEntry);
+		}
+
+		if (!OpeningBook::Write(options.bookFile.c_str(), entries)) {
+			std::cerr << "Cannot write " << options.bookFile << "\n";
+			return 1;
+		}
+		std::cout << "\nWrote " << entries.size() << " moves played at least " << options.minGames << " times to "
+			<< options.bookFile << "\n";
+	}
+	return 0;
+}
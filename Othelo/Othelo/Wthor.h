@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Board.h"
+#include "MappedFile.h"
+
+// WTHOR game database reader and statistics (console output only, no SDL)
+//
+// A .wtb file is a 16-byte header followed by 68-byte game records. Moves are stored as
+// 10 * row + column with both counted from 1 (11 = a1, 56 = f5), 0 after the last move.
+// Numbers are little-endian. Both structs only hold bytes, so they map the file in place.
+#define WTHOR_MOVES             60
+#define WTHOR_STATS_PLIES       20      // Positions counted per game, from the start
+#define WTHOR_CHUNK_GAMES       4096    // Games handed to a worker at a time
+#define WTHOR_TABLE_INITIAL_SIZE (1 << 16)  // Statistics table slots per thread, doubles as it fills
+#define WTHOR_EXPLORE_PLIES     8       // Depth of the printed main line
+#define WTHOR_EXPLORE_MOVES     4       // Moves listed per ply of the main line
+
+struct WthorHeader {
+	uint8_t century;            // Creation date
+	uint8_t year;
+	uint8_t month;
+	uint8_t day;
+	uint8_t gameCount[4];
+	uint8_t recordCount[2];     // Used by the player and tournament files
+	uint8_t gamesYear[2];
+	uint8_t boardSize;          // 0 or 8 for 8x8
+	uint8_t gameType;
+	uint8_t depth;              // Depth of the perfect play score
+	uint8_t reserved;
+};
+
+struct WthorGame {
+	uint8_t tournament[2];
+	uint8_t blackPlayer[2];
+	uint8_t whitePlayer[2];
+	uint8_t blackDiscs;         // Actual result, discs of black at the end
+	uint8_t theoreticalDiscs;   // Perfect play result from the position at header depth
+	uint8_t moves[WTHOR_MOVES];
+};
+
+static_assert(sizeof(WthorHeader) == 16, "WthorHeader must match the file layout");
+static_assert(sizeof(WthorGame) == 68, "WthorGame must match the file layout");
+
+class WthorFile {
+public:
+	// Maps the file and checks that the header matches the file size
+	bool Open(const char* path);
+	void Close();
+
+	int GetGameCount() const { return gameCount; }
+	int GetYear() const;
+	const WthorGame& GetGame(int index) const { return games[index]; }
+
+	// Square index of a stored move, -1 for the end marker or an invalid byte
+	static int DecodeMove(uint8_t move);
+
+private:
+	MappedFile file;
+	const WthorHeader* header = nullptr;
+	const WthorGame* games = nullptr;
+	int gameCount = 0;
+};
+
+struct WthorOptions {
+	std::vector<std::string> files;
+	int plies = WTHOR_STATS_PLIES;
+	int threads = 0;                    // 0 = all cores
+	int minGames = 10;                  // Moves played fewer times are left out of the book
+	std::string bookFile;               // Empty = no book
+};
+
+// Replays every game with the bitboard rules on a thread pool and counts, for each
+// (position, move) in the first plies of a game, how often it was played, won and drawn
+// by the mover and the mover's average final disc difference. Positions are keyed in
+// canonical orientation, like the opening book, so the counts can be written as one
+// (the average disc difference becomes the book score, converted to evaluator units).
+int RunWthorImport(const WthorOptions& options);
@@ -0,0 +1,228 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include "Board.h"
+#include "AI.h"
+#include "Perft.h"
+#include "Bench.h"
+#include "BookBuilder.h"
+#include "Tournament.h"
+#include "GameRecord.h"
+#include "Wthor.h"
+#include "Engine.h"
+
+// Headless command line tools: rules verification, benchmarks and data generation.
+// Links the rules engine and the AI only, so it builds anywhere without SDL.
+
+static int RunTournamentCommand(int argc, char* argv[]) {
+	TournamentOptions options;
+	if (argc < 4 || !ParseEngineSpec(argv[2], options.engineA) || !ParseEngineSpec(argv[3], options.engineB)) {
+		std::cerr << "tournament needs two engines: easy, medium, hard or expert, optionally with :depth\n";
+		return 1;
+	}
+
+	for (int i = 4; i < argc; i++) {
+		const char* option = argv[i];
+		if (i + 1 >= argc) {
+			std::cerr << "Missing value for " << option << "\n";
+			return 1;
+		}
+		const char* value = argv[++i];
+
+		if (strcmp(option, "--games") == 0) options.games = atoi(value);
+		else if (strcmp(option, "--threads") == 0) options.threads = atoi(value);
+		else if (strcmp(option, "--seed") == 0) options.seed = strtoull(value, nullptr, 10);
+		else if (strcmp(option, "--openings") == 0) options.openingsFile = value;
+		else if (strcmp(option, "--elo0") == 0) options.elo0 = atof(value);
+		else if (strcmp(option, "--elo1") == 0) options.elo1 = atof(value);
+		else if (strcmp(option, "--alpha") == 0) options.alpha = atof(value);
+		else if (strcmp(option, "--beta") == 0) options.beta = atof(value);
+		else {
+			std::cerr << "Unknown option: " << option << "\n";
+			return 1;
+		}
+	}
+
+	return RunTournament(options);
+}
+
+static int RunWthorCommand(int argc, char* argv[]) {
+	WthorOptions options;
+	for (int i = 2; i < argc; i++) {
+		const char* argument = argv[i];
+		if (strncmp(argument, "--", 2) != 0) {
+			options.files.push_back(argument);
+			continue;
+		}
+		if (i + 1 >= argc) {
+			std::cerr << "Missing value for " << argument << "\n";
+			return 1;
+		}
+		const char* value = argv[++i];
+
+		if (strcmp(argument, "--plies") == 0) options.plies = atoi(value);
+		else if (strcmp(argument, "--threads") == 0) options.threads = atoi(value);
+		else if (strcmp(argument, "--min-games") == 0) options.minGames = atoi(value);
+		else if (strcmp(argument, "--book") == 0) options.bookFile = value;
+		else {
+			std::cerr << "Unknown option: " << argument << "\n";
+			return 1;
+		}
+	}
+
+	if (options.files.empty()) {
+		std::cerr << "wthor needs at least one .wtb file\n";
+		return 1;
+	}
+	return RunWthorImport(options);
+}
+
+static int RunVariantCommand(int argc, char* argv[]) {
+	int size = (argc > 2) ? atoi(argv[2]) : 0;
+	const char* action = (argc > 3) ? argv[3] : "";
+	if (strcmp(action, "perft") == 0) {
+		return RunVariantPerft(size, (argc > 4) ? atoi(argv[4]) : 8);
+	}
+	if (strcmp(action, "check") == 0) {
+		int games = (argc > 4) ? atoi(argv[4]) : 1000;
+		unsigned seed = (argc > 5) ? static_cast<unsigned>(strtoul(argv[5], nullptr, 10)) : 1;
+		return RunVariantCheck(size, games, seed);
+	}
+	if (strcmp(action, "match") == 0 && argc > 5) {
+		int games = (argc > 6) ? atoi(argv[6]) : 10;
+		uint64_t seed = (argc > 7) ? strtoull(argv[7], nullptr, 10) : 1;
+		return RunVariantMatch(size, argv[4], argv[5], games, seed);
+	}
+	std::cerr << "variant needs a size (6, 8 or 10) and perft, check or match\n";
+	return 1;
+}
+
+static void PrintUsage() {
+	std::cout << "Usage: OtheloCLI <command> [arguments]\n"
+		<< "  perft [depth]                      Leaf counts from the start position (default 10) and regression positions\n"
+		<< "  check [games] [seed]               Compare the rules with the reference implementation (default 1000)\n"
+		<< "  movegen [positions] [seed]         Move generation throughput per kernel (default 100000)\n"
+		<< "  bench-smp [threads] [depth]        Lazy SMP search benchmark (default all cores, depth 12)\n"
+		<< "  bench-endgame [file]               Endgame solver benchmark on FFO positions, fails on a wrong score\n"
+		<< "  bench-nnue [positions] [seed]      Network evaluation throughput per kernel (default 100000)\n"
+		<< "  export-weights [file]              Write the built-in pattern weights as a weights file (default " AI_WEIGHTS_FILE ")\n"
+		<< "  export-network <file> [seed]       Write a network with random weights, loadable as " AI_NETWORK_FILE "\n"
+		<< "  check-network <file> [positions] [seed]  Search with the network, checking the accumulators (default 200)\n"
+		<< "  build-book [file] [plies] [depth]  Generate the opening book\n"
+		<< "  tournament <engineA> <engineB> [--games N] [--threads N] [--seed N] [--openings file]\n"
+		<< "             [--elo0 E] [--elo1 E] [--alpha A] [--beta B]\n"
+		<< "                                     Engine match with SPRT, engines are level[:depth] (e.g. hard, expert:12, easy:5000 playouts)\n"
+		<< "  export-records <out.txt> <records...>  Game records (.orec) to transcripts, one game per line\n"
+		<< "  import-records <in.txt> [prefix]   Transcripts to game records named prefix00001.orec... (default game)\n"
+		<< "  wthor <files.wtb...> [--plies N] [--threads N] [--min-games N] [--book file]\n"
+		<< "                                     Position statistics of WTHOR game databases, optionally written as a book\n"
+		<< "  engine                             Line-based engine protocol on stdin/stdout (see Engine.h)\n"
+		<< "  variant <size> perft [depth]       Other board sizes (6, 8, 10): leaf counts (default 8)\n"
+		<< "  variant <size> check [games] [seed]  Size-specialized rules against the reference implementation\n"
+		<< "  variant <size> match <levelA> <levelB> [games] [seed]  Level against level (default 10 games)\n";
+}
+
+int main(int argc, char* argv[]) {
+	if (argc < 2) {
+		PrintUsage();
+		return 1;
+	}
+
+	const char* command = argv[1];
+	if (strcmp(command, "perft") == 0) {
+		return RunPerft((argc > 2) ? atoi(argv[2]) : 10);
+	}
+	if (strcmp(command, "check") == 0) {
+		int games = (argc > 2) ? atoi(argv[2]) : 1000;
+		unsigned seed = (argc > 3) ? static_cast<unsigned>(strtoul(argv[3], nullptr, 10)) : 1;
+		return RunRulesCheck(games, seed);
+	}
+	if (strcmp(command, "movegen") == 0) {
+		int positions = (argc > 2) ? atoi(argv[2]) : 100000;
+		unsigned seed = (argc > 3) ? static_cast<unsigned>(strtoul(argv[3], nullptr, 10)) : 1;
+		return RunMoveGenBenchmark(positions, seed);
+	}
+	if (strcmp(command, "bench-smp") == 0) {
+		int threads = (argc > 2) ? atoi(argv[2]) : 0;
+		int depth = (argc > 3) ? atoi(argv[3]) : 12;
+		return RunSmpBenchmark(threads, depth);
+	}
+	if (strcmp(command, "bench-endgame") == 0) {
+		return RunEndgameBenchmark((argc > 2) ? argv[2] : nullptr);
+	}
+	if (strcmp(command, "bench-nnue") == 0) {
+		int positions = (argc > 2) ? atoi(argv[2]) : 100000;
+		unsigned seed = (argc > 3) ? static_cast<unsigned>(strtoul(argv[3], nullptr, 10)) : 1;
+		return RunNetworkBenchmark(positions, seed);
+	}
+	if (strcmp(command, "export-weights") == 0) {
+		const char* path = (argc > 2) ? argv[2] : AI_WEIGHTS_FILE;
+		PatternEvaluator evaluator;
+		if (!evaluator.SaveWeights(path)) {
+			std::cerr << "Cannot write " << path << "\n";
+			return 1;
+		}
+		std::cout << "Wrote " << PatternEvaluator::GetWeightCount() << " built-in pattern weights to " << path << "\n";
+		return 0;
+	}
+	if (strcmp(command, "export-network") == 0) {
+		if (argc < 3) {
+			std::cerr << "export-network needs an output file\n";
+			return 1;
+		}
+		unsigned seed = (argc > 3) ? static_cast<unsigned>(strtoul(argv[3], nullptr, 10)) : 1;
+		NnueEvaluator network;
+		network.RandomizeWeights(seed);
+		if (!network.SaveWeights(argv[2])) {
+			std::cerr << "Cannot write " << argv[2] << "\n";
+			return 1;
+		}
+		std::cout << "Wrote a network with random weights (seed " << seed << ") to " << argv[2] << "\n";
+		return 0;
+	}
+	if (strcmp(command, "check-network") == 0) {
+		if (argc < 3) {
+			std::cerr << "check-network needs a network file\n";
+			return 1;
+		}
+		int positions = (argc > 3) ? atoi(argv[3]) : 200;
+		unsigned seed = (argc > 4) ? static_cast<unsigned>(strtoul(argv[4], nullptr, 10)) : 1;
+		return RunNetworkSearchCheck(argv[2], positions, seed);
+	}
+	if (strcmp(command, "build-book") == 0) {
+		const char* path = (argc > 2) ? argv[2] : AI_BOOK_FILE;
+		int plies = (argc > 3) ? atoi(argv[3]) : BOOK_BUILD_PLIES;
+		int depth = (argc > 4) ? atoi(argv[4]) : BOOK_BUILD_DEPTH;
+		return BuildOpeningBook(path, plies, depth);
+	}
+	if (strcmp(command, "variant") == 0) {
+		return RunVariantCommand(argc, argv);
+	}
+	if (strcmp(command, "tournament") == 0) {
+		return RunTournamentCommand(argc, argv);
+	}
+	if (strcmp(command, "wthor") == 0) {
+		return RunWthorCommand(argc, argv);
+	}
+	if (strcmp(command, "engine") == 0) {
+		return RunEngineProtocol(std::cin, std::cout);
+	}
+	if (strcmp(command, "export-records") == 0) {
+		if (argc < 4) {
+			std::cerr << "export-records needs an output file and at least one record\n";
+			return 1;
+		}
+		return ExportTranscripts(argv[2], argv + 3, argc - 3);
+	}
+	if (strcmp(command, "import-records") == 0) {
+		if (argc < 3) {
+			std::cerr << "import-records needs a transcript file\n";
+			return 1;
+		}
+		return ImportTranscripts(argv[2], (argc > 3) ? argv[3] : "game");
+	}
+
+	std::cerr << "Unknown command: " << command << "\n";
+	PrintUsage();
+	return 1;
+}